@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace veqtor::bench {
+/**
+ * @brief The benchmark class
+ * @abstract Times callables and collects the results as JSON objects:
+ *  `{suite, name, iterations, min_ms, median_ms, mean_ms, ...extra}`.
+ */
+class benchmark {
+public:
+    explicit benchmark(const QString &filter = QString(), int iterations = 10)
+        : mFilter(filter), mIterations(std::max(iterations, 1)) {}
+
+    /** @return true if the benchmark is selected by the `--filter` option. */
+    bool enabled(const QString &suite, const QString &name) const {
+        return mFilter.isEmpty() || (suite + "/" + name).contains(mFilter);
+    }
+
+    /**
+     * @brief run
+     * @abstract Calls @a func once to warm up, then times it for the configured iterations.
+     * @param extra, Additional fields of the result, e.g. sizes.
+     * @param ops, Number of operations done by each call, it's used to report the throughput.
+     * @return The result object, or an empty object if the benchmark is filtered out.
+     */
+    template<typename Func>
+    QJsonObject run(const QString &suite, const QString &name, Func &&func,
+                    const QJsonObject &extra = {}, double ops = 0) {
+        if(!enabled(suite, name)) return {};
+
+        func();
+        std::vector<double> times;
+        times.reserve(mIterations);
+
+        QElapsedTimer timer;
+        for(int i = 0; i < mIterations; ++i) {
+            timer.start();
+            func();
+            times.push_back(timer.nsecsElapsed() / 1e6);
+        }
+        return record(suite, name, times, extra, ops);
+    }
+
+    /** @brief record, Adds externally measured times (in milliseconds) to the results. */
+    QJsonObject record(const QString &suite, const QString &name, std::vector<double> times,
+                       const QJsonObject &extra = {}, double ops = 0) {
+        if(times.empty()) return {};
+        std::sort(times.begin(), times.end());
+
+        QJsonObject result = extra;
+        result["suite"] = suite;
+        result["name"] = name;
+        result["iterations"] = int(times.size());
+        result["min_ms"] = times.front();
+        result["median_ms"] = times[times.size() / 2];
+        result["mean_ms"] = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        if(ops > 0 && times[times.size() / 2] > 0) {
+            result["ops_per_sec"] = ops / (times[times.size() / 2] / 1e3);
+        }
+
+        mResults.append(result);
+        return result;
+    }
+
+    int iterations() const { return mIterations; }
+    const QJsonArray &results() const { return mResults; }
+
+private:
+    QString mFilter;
+    int mIterations;
+    QJsonArray mResults;
+};
+} // namespace veqtor::bench
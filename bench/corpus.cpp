@@ -0,0 +1,76 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <random>
+
+#include "corpus.h"
+
+namespace veqtor::bench {
+QString corpus::pathData(int segments, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> coord(0, 100), delta(-10, 10);
+    const auto number = [](double value) { return QString::number(value, 'f', 2); };
+
+    QString data;
+    data.reserve(segments * 24);
+    data += "M" + number(coord(random)) + "," + number(coord(random));
+
+    for(int i = 0; i < segments; ++i) {
+        switch(random() % 9) {
+            case 0: data += "L" + number(coord(random)) + " " + number(coord(random)); break;
+            /// Negative relative coordinates don't need separators (e.g. `l1.5-2.25`).
+            case 1: data += "l" + number(delta(random)) + number(-std::abs(delta(random))); break;
+            case 2: data += "h" + number(delta(random)) + "v" + number(delta(random)); i++; break;
+            case 3: data += "C" + number(coord(random)) + "," + number(coord(random)) + " " +
+                            number(coord(random)) + "," + number(coord(random)) + " " +
+                            number(coord(random)) + "," + number(coord(random)); break;
+            case 4: data += "s" + number(delta(random)) + " " + number(delta(random)) + " " +
+                            number(delta(random)) + " " + number(delta(random)); break;
+            case 5: data += "Q" + number(coord(random)) + " " + number(coord(random)) + " " +
+                            number(coord(random)) + " " + number(coord(random)); break;
+            case 6: data += "t" + number(delta(random)) + " " + number(delta(random)); break;
+            case 7: data += "a5 5 0 1" + QString::number(random() % 2) + number(delta(random)) + " " +
+                            number(delta(random)); break;
+            default: data += "z m" + number(delta(random)) + " " + number(delta(random)); break;
+        }
+    }
+    return data;
+}
+
+QString corpus::svgDocument(int elements, int segments, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> position(0, 900);
+
+    QString svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 1000 1000\">\n";
+    for(int i = 0; i < elements; ++i) {
+        svg += QString("<path id=\"p%1\" fill=\"#%2\" stroke=\"black\" stroke-width=\"0.5\" "
+                       "transform=\"translate(%3, %4)\" d=\"%5\"/>\n")
+                   .arg(i).arg(random() % 0xffffff, 6, 16, QChar('0'))
+                   .arg(position(random), 0, 'f', 1).arg(position(random), 0, 'f', 1)
+                   .arg(pathData(segments, seed + i));
+    }
+    return svg + "</svg>\n";
+}
+
+std::vector<corpus::document> corpus::synthetic() {
+    return {
+        {"synthetic-100x20", svgDocument(100, 20)},
+        {"synthetic-1000x20", svgDocument(1000, 20)},
+        {"synthetic-10000x20", svgDocument(10000, 20)},
+        {"synthetic-100x1000", svgDocument(100, 1000)},
+    };
+}
+
+std::vector<corpus::document> corpus::files(const QStringList &directories) {
+    std::vector<document> documents;
+    for(const QString &directory: directories) {
+        const auto entries = QDir(directory).entryInfoList({"*.svg"}, QDir::Files, QDir::Name);
+        for(const QFileInfo &info: entries) {
+            QFile file(info.filePath());
+            if(file.open(QFile::ReadOnly)) documents.push_back({info.fileName(), QString::fromUtf8(file.readAll())});
+        }
+    }
+    return documents;
+}
+} // namespace veqtor::bench
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+namespace veqtor::bench {
+/**
+ * @brief The corpus class
+ * @abstract Benchmark inputs. Synthetic documents are generated with a fixed seed,
+ *  so the same sizes produce the same data on every run.
+ */
+class corpus {
+public:
+    struct document { QString name; QString data; };
+
+    /**
+     * @brief pathData
+     * @return Path data with @a segments segments, it mixes all of the path commands,
+     *  absolute and relative forms and compact number separators.
+     */
+    static QString pathData(int segments, unsigned seed = 1);
+
+    /**
+     * @brief svgDocument
+     * @return An SVG document of @a elements paths with @a segments segments each, spread over a 1000x1000 view box.
+     */
+    static QString svgDocument(int elements, int segments, unsigned seed = 1);
+
+    /** @return Synthetic documents of increasing sizes. */
+    static std::vector<document> synthetic();
+
+    /** @return All of the `*.svg` files in the given directories. */
+    static std::vector<document> files(const QStringList &directories);
+};
+} // namespace veqtor::bench
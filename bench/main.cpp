@@ -0,0 +1,335 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QGuiApplication>
+#include <QHoverEvent>
+#include <QJsonDocument>
+#include <QQuickWindow>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QThread>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <functional>
+#include <random>
+#include <regex>
+#include <thread>
+
+#include "veqtor.h"
+#include "renderer.h"
+#include "scene.h"
+#include "utils/svgtools.h"
+#include "utils/tools.h"
+
+#include "benchmark.h"
+#include "corpus.h"
+
+#ifndef VEQTOR_BENCH_CORPUS
+#define VEQTOR_BENCH_CORPUS ""
+#endif
+
+using namespace veqtor;
+using bench::benchmark;
+using bench::corpus;
+
+/** @return Resident memory of the process in bytes, or -1 if it's not available. */
+static qint64 residentMemory() {
+    QFile statm("/proc/self/statm");
+    if(!statm.open(QFile::ReadOnly)) return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * 4096 : -1;
+}
+
+/** @return Peak resident memory of the process (`VmHWM`) in bytes, or -1 if it's not available. */
+static qint64 peakResidentMemory() {
+    QFile status("/proc/self/status");
+    if(!status.open(QFile::ReadOnly)) return -1;
+    for(const QByteArray &line: status.readAll().split('\n')) {
+        if(line.startsWith("VmHWM:")) return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+    }
+    return -1;
+}
+
+/**
+ * @return The peak resident memory that @a load adds to the process, or -1 if it's not available (Linux only).
+ *  The freed memory is returned to the system and the peak is reset to the current memory first, so each loader is
+ *  measured on its own, including its temporary data (e.g. the DOM of `svgDomParser`).
+ */
+static qint64 peakMemory(const std::function<void()> &load) {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    const qint64 before = residentMemory();
+    /// Writing 5 to `clear_refs` resets `VmHWM` to the current resident memory.
+    QFile clearRefs("/proc/self/clear_refs");
+    if(before < 0 || !clearRefs.open(QFile::WriteOnly) || clearRefs.write("5") != 1) return -1;
+    clearRefs.close();
+
+    load();
+    const qint64 peak = peakResidentMemory();
+    return peak < 0 ? -1 : peak - before;
+}
+
+static int countElements(const QPointer<elements::element> &root) {
+    int count = 0;
+    elements::container::walk(root, [&count](const QPointer<elements::element> &) { ++count; });
+    return count;
+}
+
+/**
+ * The regex tokenizer that `svgPathParser` replaced, as the baseline of the `parse` suite.
+ * It only splits the commands and converts their numbers (the path is not built), so it's a lower bound of its cost.
+ * @return The number of the parsed numbers.
+ */
+static size_t regexPathParser(const QString &svgPath) {
+    static const std::regex reg(R"([a-zA-Z][^a-zA-Z]*)");
+    static const std::regex subReg(R"(-?\d*\.?\d*)");
+    size_t numbers = 0;
+    for(const auto &m: utils::tools::globalMatch(svgPath.toStdString(), reg)) {
+        numbers += utils::tools::stodVec(utils::tools::globalMatch(m, subReg)).size();
+    }
+    return numbers;
+}
+
+/// Tokenizer throughput over path data of increasing sizes, against the regex implementation.
+static void pathParser(benchmark &b) {
+    for(const int segments: {1000, 10000, 100000}) {
+        const QString data = corpus::pathData(segments);
+        const QJsonObject extra{{"bytes", data.size() * 2}, {"segments", qint64(segments)}};
+        size_t parsed = 0;
+        b.run("parse", QString("svgPathParser/%1").arg(segments), [&]() {
+            parsed = utils::svgTools::svgPathParser(data).size();
+        }, extra, data.size() * 2.0);
+        b.run("parse", QString("regexPathParser/%1").arg(segments), [&]() {
+            parsed = regexPathParser(data);
+        }, extra, data.size() * 2.0);
+        Q_UNUSED(parsed)
+    }
+}
+
+/// Document build time and memory, for the scene, the element tree of the stream parser and the old DOM parser.
+static void treeBuild(benchmark &b, const std::vector<corpus::document> &documents) {
+    for(const auto &doc: documents) {
+        const auto parse = [&doc](bool dom) {
+            QPointer<elements::element> root = dom ? utils::svgTools::svgDomParser(doc.data)
+                                                   : utils::svgTools::svgParser(doc.data);
+            delete root.data();
+        };
+
+        QPointer<elements::element> root = utils::svgTools::svgParser(doc.data);
+        const int count = countElements(root);
+        delete root.data();
+
+        /// Each loader is measured separately, the result is released before the next one.
+        QJsonObject extra{{"bytes", doc.data.size() * 2}, {"elements", count}};
+        extra["peak_bytes"] = peakMemory([&]() { parse(false); });
+        b.run("build", "svgParser/" + doc.name, [&]() { parse(false); }, extra);
+
+        extra["peak_bytes"] = peakMemory([&]() { parse(true); });
+        b.run("build", "svgDomParser/" + doc.name, [&]() { parse(true); }, extra);
+
+        extra["peak_bytes"] = peakMemory([&]() { utils::svgTools::sceneParser(doc.data); });
+        b.run("build", "sceneParser/" + doc.name, [&]() { utils::svgTools::sceneParser(doc.data); }, extra);
+    }
+}
+
+/**
+ * Frame time of a document rendered into an offscreen window.
+ * Each frame is grabbed, so it includes a read back, and a frame of an empty document is reported as the baseline.
+ */
+static void paint(benchmark &b, const std::vector<corpus::document> &documents) {
+    QQuickWindow window;
+    window.resize(1000, 1000);
+    auto *item = new canvas::veqtor(window.contentItem());
+    item->setSize(QSizeF(1000, 1000));
+
+    const auto frame = [&]() {
+        item->QQuickItem::update();
+        window.grabWindow();
+    };
+
+    item->setSrc("<svg viewBox=\"0 0 1000 1000\"></svg>");
+    b.run("paint", "baseline", frame);
+
+    for(const auto &doc: documents) {
+        if(!b.enabled("paint", doc.name)) continue;
+        item->setSrc(doc.data);
+        b.run("paint", doc.name, frame, {{"elements", item->scene() ? item->scene()->size() : 0}});
+    }
+}
+
+/**
+ * Offscreen (CPU) render throughput into 512x512 images.
+ * `render/<doc>` renders a loaded scene on the main thread, `render/parallel/<doc>` renders a scene per thread
+ *  on all cores at once, so its throughput shows how the renderer scales.
+ */
+static void render(benchmark &b, const std::vector<corpus::document> &documents) {
+    const QSize size(512, 512);
+    const int threads = std::max(QThread::idealThreadCount(), 1);
+    constexpr int frames = 4;
+
+    for(const auto &doc: documents) {
+        const auto scene = utils::svgTools::sceneParser(doc.data);
+        if(scene && b.enabled("render", doc.name)) {
+            QImage image;
+            b.run("render", doc.name, [&]() { canvas::renderer::render(*scene, size, image); },
+                  {{"elements", scene->size()}}, 1);
+        }
+
+        if(!b.enabled("render", "parallel/" + doc.name)) continue;
+        b.run("render", "parallel/" + doc.name, [&]() {
+            /// Each thread parses its own scene, the scenes are not shared.
+            std::vector<std::thread> workers;
+            for(int t = 0; t < threads; ++t) {
+                workers.emplace_back([&]() {
+                    const auto document = utils::svgTools::sceneParser(doc.data);
+                    QImage image;
+                    for(int i = 0; document && i < frames; ++i) canvas::renderer::render(*document, size, image);
+                });
+            }
+            for(auto &worker: workers) worker.join();
+        }, {{"threads", threads}, {"frames", threads * frames}}, threads * frames);
+    }
+}
+
+/// Hover hit-test latency over uniformly distributed points.
+static void hitTest(benchmark &b, const std::vector<corpus::document> &documents) {
+    constexpr int events = 1000;
+    canvas::veqtor item;
+    item.setSize(QSizeF(1000, 1000));
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> coord(0, 1000);
+    std::vector<QPointF> points(events);
+    for(auto &point: points) point = QPointF(coord(random), coord(random));
+
+    for(const auto &doc: documents) {
+        if(!b.enabled("hit-test", doc.name)) continue;
+        item.setSrc(doc.data);
+
+        b.run("hit-test", "hoverMoveEvent/" + doc.name, [&]() {
+            QPointF last;
+            for(const QPointF &point: points) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+                QHoverEvent event(QEvent::HoverMove, point, point, last);
+#else
+                QHoverEvent event(QEvent::HoverMove, point, last);
+#endif
+                item.hoverMoveEvent(&event);
+                last = point;
+            }
+        }, {{"events", events}}, events);
+
+        b.run("hit-test", "elementsAt/" + doc.name, [&]() {
+            for(const QPointF &point: points) item.elementsAt(point);
+        }, {{"events", events}}, events);
+    }
+}
+
+/// Mutation rates of a path, and a series, inside a loaded document.
+static void mutation(benchmark &b) {
+    constexpr int operations = 10000;
+    canvas::veqtor item;
+    item.setSize(QSizeF(1000, 1000));
+    item.setSrc("<svg viewBox=\"0 0 1000 1000\"><path id=\"path\" stroke=\"black\"/>"
+                "<series id=\"series\" capacity=\"100000\" stroke=\"black\"/></svg>");
+
+    auto *path = qobject_cast<elements::epath *>(item.getElementById("path").value<QObject *>());
+    auto *series = qobject_cast<elements::eseries *>(item.getElementById("series").value<QObject *>());
+    if(!path || !series) {
+        qWarning("veqtor_bench: the mutation document has not been loaded.");
+        return;
+    }
+
+    b.run("mutation", "epath/lineTo", [&]() {
+        path->clear();
+        for(int i = 0; i < operations; ++i) path->lineTo(QPointF(i % 1000, i % 997));
+    }, {{"operations", operations}}, operations);
+
+    b.run("mutation", "epath/set", [&]() {
+        for(int i = 0; i < operations; ++i) path->set(i, QPointF(i % 997, i % 1000));
+    }, {{"operations", operations}}, operations);
+
+    b.run("mutation", "epath/shift", [&]() {
+        for(int i = 0; i < operations; ++i) path->lineTo(QPointF(i % 1000, i % 997));
+        for(int i = 0; i < operations; ++i) path->shift();
+    }, {{"operations", operations}}, operations * 2.0);
+
+    b.run("mutation", "series/append", [&]() {
+        series->clear();
+        for(int i = 0; i < operations; ++i) series->append(QPointF(i, i % 997));
+        QCoreApplication::processEvents();
+    }, {{"operations", operations}}, operations);
+
+    b.run("mutation", "series/shift", [&]() {
+        for(int i = 0; i < operations; ++i) {
+            series->append(QPointF(i, i % 997));
+            series->shift();
+        }
+        QCoreApplication::processEvents();
+    }, {{"operations", operations}}, operations * 2.0);
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("veqtor_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Veqtor benchmarks, results are written as JSON.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"o", "output"}, "Write the results to <file> instead of the standard output.", "file"},
+        {{"f", "filter"}, "Run only the benchmarks whose \"suite/name\" contains <text>.", "text"},
+        {{"i", "iterations"}, "Number of timed iterations of each benchmark.", "count", "10"},
+        {{"c", "corpus"}, "Add the *.svg files of <directory> to the corpus.", "directory"},
+        {"no-paint", "Skip the paint benchmarks (e.g. when there is no OpenGL)."},
+    });
+    parser.process(app);
+
+    benchmark b(parser.value("filter"), parser.value("iterations").toInt());
+
+    std::vector<corpus::document> documents = corpus::synthetic();
+    QStringList directories = parser.values("corpus");
+    if(!QString(VEQTOR_BENCH_CORPUS).isEmpty()) directories.prepend(VEQTOR_BENCH_CORPUS);
+    const auto files = corpus::files(directories);
+    documents.insert(documents.end(), files.begin(), files.end());
+
+    pathParser(b);
+    treeBuild(b, documents);
+    if(!parser.isSet("no-paint")) paint(b, documents);
+    render(b, documents);
+    hitTest(b, documents);
+    mutation(b);
+
+    const QJsonObject report{
+        {"version", 1},
+        {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"qt", qVersion()},
+        {"os", QSysInfo::prettyProductName()},
+        {"cpu", QSysInfo::currentCpuArchitecture()},
+#ifdef NDEBUG
+        {"build", "release"},
+#else
+        {"build", "debug"},
+#endif
+        {"iterations", b.iterations()},
+        {"results", b.results()},
+    };
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if(parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if(!file.open(QFile::WriteOnly)) {
+            qWarning("veqtor_bench: can't write to %s", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include "displaylist.h"
+#include "utils/simdtools.h"
+
+namespace veqtor::canvas {
+void displayList::build(const core::scene &scene) {
+    const auto &graphics = scene.graphics();
+    mItems.clear();
+    mItems.reserve(graphics.size());
+    mBounds.resize(4 * graphics.size());
+    for(const int node: graphics) {
+        mItems.push_back(resolve(scene, node));
+        setBounds(mItems.size() - 1, mItems.back().paintRect);
+    }
+}
+
+void displayList::build(const std::vector<QPointer<elements::graphic>> &graphics) {
+    mItems.clear();
+    mItems.reserve(graphics.size());
+    mBounds.resize(4 * graphics.size());
+    for(const auto &graphic: graphics) {
+        mItems.push_back(graphic ? resolve(*graphic) : item());
+        setBounds(mItems.size() - 1, mItems.back().paintRect);
+    }
+}
+
+void displayList::update(int id, const core::scene &scene) {
+    if(id >= 0 && size_t(id) < mItems.size()) {
+        mItems[id] = resolve(scene, scene.graphics()[id]);
+        setBounds(id, mItems[id].paintRect);
+    }
+}
+
+void displayList::update(int id, const elements::graphic &graphic) {
+    if(id >= 0 && size_t(id) < mItems.size()) {
+        mItems[id] = resolve(graphic);
+        setBounds(id, mItems[id].paintRect);
+    }
+}
+
+void displayList::remove(int id) {
+    if(id >= 0 && size_t(id) < mItems.size()) {
+        mItems[id] = item();
+        setBounds(id, QRectF());
+    }
+}
+
+void displayList::setRootTransform(const QTransform &rootTransform) {
+    mRootTransform = rootTransform;
+    for(item &i: mItems) i.device = i.world * mRootTransform;
+}
+
+void displayList::cull(const QRectF &viewport, std::vector<std::uint8_t> &inside) const {
+    inside.resize(mItems.size());
+    /// The viewport is mapped to the root coordinates once, instead of mapping the rect of each item to the device.
+    bool invertible = false;
+    const QTransform inverse = mRootTransform.inverted(&invertible);
+    if(!invertible) {
+        std::fill(inside.begin(), inside.end(), 0);
+        return;
+    }
+    utils::simdTools::intersects(mBounds.data(), mItems.size(), inverse.mapRect(viewport), inside.data());
+}
+
+void displayList::snapshot(const QRectF &viewport, std::vector<item> &frame, std::vector<std::uint8_t> &inside) const {
+    cull(viewport, inside);
+    frame.clear();
+    for(size_t i = 0; i < mItems.size(); ++i) {
+        if(!mItems[i].visible || !inside[i]) continue;
+
+        item copy = mItems[i];
+        if(copy.type == shapes::Rect) {
+            /// The shape type is resolved in the list, so the shape is cast statically.
+            const auto &rect = static_cast<const shapes::rect &>(*copy.shape);
+            copy.box = rect;
+            /// Corners with different radiuses are not supported by NanoVG, they are drawn with the first one.
+            copy.radius = rect.radiuses()[0];
+        } else if(copy.type == shapes::Ellipse) {
+            copy.box = copy.shape->boundingBox();
+        } else if(copy.geometry) {
+            copy.frame = copy.geometry->share(*copy.shape, copy.device);
+        }
+        copy.shape = nullptr;
+        copy.geometry = nullptr;
+        frame.push_back(std::move(copy));
+    }
+}
+
+void displayList::setBounds(size_t id, const QRectF &rect) {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    float *b = mBounds.data() + 4 * id;
+    if(rect.isNull()) {
+        b[0] = b[1] = -inf;
+        b[2] = b[3] = inf;
+    } else {
+        b[0] = rect.left(); b[1] = rect.top();
+        b[2] = rect.right(); b[3] = rect.bottom();
+    }
+}
+
+displayList::item displayList::resolve(const core::scene &scene, int node) const {
+    const shapes::shape *shape = scene[node].shape.get();
+    if(!shape) return item();
+
+    item i = resolve(shape, scene.world(node), scene.worldOpacity(node));
+    i.geometry = scene.geometry(node);
+    i.paintRect = scene.paintRect(node);
+    return i;
+}
+
+displayList::item displayList::resolve(const elements::graphic &graphic) const {
+    const shapes::shape *shape = graphic.shape().get();
+    if(!shape) return item();
+
+    item i = resolve(shape, graphic.worldTransform(), graphic.worldOpacity());
+    i.geometry = &graphic.geometryCache();
+    i.paintRect = graphic.paintRect();
+    return i;
+}
+
+displayList::item displayList::resolve(const shapes::shape *shape, const QTransform &world, qreal opacity) const {
+    item i;
+    i.shape = shape;
+    i.type = shape->type();
+    if(shape->pen().mOpacity == static_cast<float>(opacity)) {
+        i.pen = shape->sharedPen();
+    } else {
+        core::nanoPen pen = shape->pen();
+        pen.mOpacity = static_cast<float>(opacity);
+        i.pen = core::penTable::intern(pen);
+    }
+    i.world = world;
+    i.device = i.world * mRootTransform;
+    i.visible = i.type != shapes::Shape && i.pen->visible() && !shape->isNull();
+    return i;
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QPointer>
+#include <QRectF>
+#include <QTransform>
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "nanopen.h"
+#include "scene.h"
+#include "shapes/shapes.h"
+#include "elements/graphic.h"
+
+namespace veqtor::canvas {
+/**
+ * @brief The displayList class
+ * @abstract A flat list of the graphics in paint order, with their resolved paint state.
+ *  It's built from the graphic nodes of a `core::scene` (or from the graphic elements of a tree), and a changed
+ *  graphic only re-resolves its own item, so a frame is a linear pass over contiguous items, without tree walks,
+ *  casts or QPointer checks. Item indices are the paint order ids of the graphics.
+ */
+class displayList {
+public:
+    struct item {
+        /// The retained geometry of the shape, of its scene node or of its element.
+        const shapes::geometryCache *geometry = nullptr;
+        const shapes::shape *shape = nullptr;
+        shapes::ShapeType type = shapes::Shape;
+        /// The pen with the world opacity, an entry of the `core::penTable`.
+        core::penTable::handle pen = core::penTable::defaultPen();
+        /// Transforms from the shape coordinates to the root coordinates, and to the device.
+        QTransform world;
+        QTransform device;
+        QRectF paintRect;
+        bool visible = false;
+        /// The paint data of a snapshot item (see `snapshot`): the geometry, or the box and the corner radius
+        ///  of rects and ellipses. Snapshot items have no shape or cache.
+        std::shared_ptr<const shapes::geometry> frame;
+        QRectF box;
+        float radius = 0.0f;
+    };
+
+    /** @brief build, Re-creates the list from the graphic nodes of a scene, the ids are the scene graphic ids. */
+    void build(const core::scene &scene);
+    /** @brief build, Re-creates the list from the graphics in paint order. */
+    void build(const std::vector<QPointer<elements::graphic>> &graphics);
+    /** @brief update, Re-resolves the item of a changed graphic node. */
+    void update(int id, const core::scene &scene);
+    /** @brief update, Re-resolves the item of a changed graphic. */
+    void update(int id, const elements::graphic &graphic);
+    /** @brief remove, Disables the item of a destroyed graphic, the ids of the other items are kept. */
+    void remove(int id);
+    void clear() { mItems.clear(); mBounds.clear(); }
+    /** @brief setRootTransform, Sets the root to device transform, and updates the device transforms of the items. */
+    void setRootTransform(const QTransform &rootTransform);
+
+    /**
+     * @brief cull
+     * @abstract Tests the paint rects of all items against the @a viewport (in device coordinates) in one batch.
+     *  Items with a null paint rect are never culled.
+     * @param inside, receives 1 for each item that intersects the viewport.
+     */
+    void cull(const QRectF &viewport, std::vector<std::uint8_t> &inside) const;
+
+    /**
+     * @brief snapshot
+     * @abstract Copies the visible items that intersect the @a viewport (in device coordinates) with their paint
+     *  data, so the copy is painted without reading the shapes or their caches, e.g. on the render thread while
+     *  the GUI thread changes the document. The geometry is shared with the caches, they rebuild into new ones.
+     * @param frame, receives the items in paint order.
+     * @param inside, the culling buffer, see `cull`.
+     */
+    void snapshot(const QRectF &viewport, std::vector<item> &frame, std::vector<std::uint8_t> &inside) const;
+
+    const std::vector<item> &items() const { return mItems; }
+    size_t size() const { return mItems.size(); }
+
+private:
+    item resolve(const core::scene &scene, int node) const;
+    item resolve(const elements::graphic &graphic) const;
+    /// Resolves the paint state of a shape with its world state.
+    item resolve(const shapes::shape *shape, const QTransform &world, qreal opacity) const;
+    void setBounds(size_t id, const QRectF &rect);
+
+    std::vector<item> mItems;
+    /// Paint rects of the items (left, top, right, bottom) in the root coordinates, packed for culling.
+    std::vector<float> mBounds;
+    QTransform mRootTransform;
+};
+}
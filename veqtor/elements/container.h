@@ -5,6 +5,7 @@
 #include <QQmlListProperty>
 
 #include "../shapes/shapes.h"
+#include "../scene.h"
 #include "element.h"
 
 #if QT_VERSION >= 0x060000
@@ -21,34 +22,48 @@ class container: public element {
     Q_PROPERTY(QQmlListProperty<element> children READ childrenList NOTIFY childrenListChanged)
 public:
     explicit container(QObject *parent = nullptr,
-                       const QMap<QString, QString> &attrs = {},
+                       const utils::attributeList &attrs = {},
                        const std::vector<el_ptr> &els = {})
-        : element{parent, attrs}, mChildren(els.begin(), els.end()) {}
+        : element{parent, attrs}, mChildren(els.begin(), els.end()) {
+        for(const auto &child: els) if(child && child->parent() != this) child->setParent(this);
+    }
 
     /// operators
-    const el_ptr &operator[](size_t i) const { return mChildren[i]; }
-    el_ptr &operator[](size_t i) { return mChildren[i]; }
+    const el_ptr &operator[](size_t i) const { loadChildren(); return mChildren[i]; }
+    el_ptr &operator[](size_t i) { loadChildren(); return mChildren[i]; }
 
     /// setters
     virtual void push_back(const el_ptr &childElement) {
+        /// The scene nodes are stored in paint order, so a loaded document can't be restructured.
+        if(mScene) {
+            qWarning("Veqtor: elements can't be added to a loaded document.");
+            return;
+        }
         mChildren.push_back(childElement);
+        /// The child inherits the world transform and opacity of this container, through its parent.
+        if(childElement) {
+            if(childElement->parent() != this) childElement->setParent(this);
+            childElement->invalidateWorld();
+        }
+        notify(&container::childrenListChanged);
     }
 
     /// getters
-    QVector<el_ptr>::iterator begin() { return mChildren.begin(); }
-    QVector<el_ptr>::iterator end() { return mChildren.end(); }
-    QVector<el_ptr>::const_iterator cbegin() { return mChildren.cbegin(); }
-    QVector<el_ptr>::const_iterator cend() { return mChildren.cend(); }
+    QVector<el_ptr>::iterator begin() { loadChildren(); return mChildren.begin(); }
+    QVector<el_ptr>::iterator end() { loadChildren(); return mChildren.end(); }
+    QVector<el_ptr>::const_iterator cbegin() { loadChildren(); return mChildren.cbegin(); }
+    QVector<el_ptr>::const_iterator cend() { loadChildren(); return mChildren.cend(); }
 
-    bool empty() { return mChildren.empty(); }
-    int size() { return mChildren.size(); }
+    bool empty() { loadChildren(); return mChildren.empty(); }
+    int size() { loadChildren(); return mChildren.size(); }
 
     QQmlListProperty<element> childrenList() {
+        loadChildren();
         using qq_list_prop = QQmlListProperty<element>;
         static auto cast = [](qq_list_prop *l){ return reinterpret_cast<QVector<el_ptr>*>(l->data); };
         static auto repl = [](qq_list_prop *l, veq_list_size  i, element *el){ cast(l)->replace(i, el); };
         static auto at   = [](qq_list_prop *l, veq_list_size  i){ return cast(l)->at(i).data(); };
-        static auto app  = [](qq_list_prop *l, element *el){ cast(l)->push_back(el); };
+        static auto app  = [](qq_list_prop *l, element *el){ static_cast<container *>(l->object)->push_back(el); };
         static auto pop  = [](qq_list_prop *l){ return cast(l)->pop_back(); };
         static auto clr  = [](qq_list_prop *l){ return cast(l)->clear(); };
         static auto size = [](qq_list_prop *l)->veq_list_size { return cast(l)->size(); };
@@ -108,9 +123,27 @@ public:
             for(const auto &child: *cont) walk(child, func);
         }
     }
+protected:
+    /// Only the children that are already created are notified, the others read their world state from the scene.
+    void invalidateChildren() override {
+        for(const auto &child: qAsConst(mChildren)) {
+            if(!child) continue;
+            child->invalidateWorld();
+            child->notify(&element::updated);
+        }
+    }
+
+    /// The children of a bound container are created (all at once) on the first access.
+    void loadChildren() const {
+        if(!mScene || mChildrenLoaded) return;
+        mChildrenLoaded = true;
+        for(const int child: mScene->children(mNode)) mChildren.push_back(mScene->wrapper(child));
+    }
+
 signals:
     void childrenListChanged();
 protected:
-    QVector<el_ptr> mChildren;
+    mutable QVector<el_ptr> mChildren;
+    mutable bool mChildrenLoaded = false;
 };
 }
@@ -0,0 +1,83 @@
+#include "eellipse.h"
+
+namespace veqtor::elements {
+using utils::tools;
+
+eellipse::eellipse(const utils::attributeList &attrs, QObject *parent)
+    : eellipse{shapeFrom(attrs), attrs, parent} {}
+
+eellipse::eellipse(const std::shared_ptr<shapes::ellipse> &shape, const utils::attributeList &attrs, QObject *parent)
+    : graphic{shape, parent, attrs} {
+    dropAttributes(mainAttrs());
+}
+
+std::shared_ptr<shapes::ellipse> eellipse::shapeFrom(const utils::attributeList &attrs) {
+    /// If only one of the radiuses is given, the other one is the same.
+    return shapeFrom(attrs, attrs.value("rx", attrs["ry"]), attrs.value("ry", attrs["rx"]));
+}
+
+std::shared_ptr<shapes::ellipse> eellipse::shapeFrom(const utils::attributeList &attrs,
+                                                     const QString &rx, const QString &ry) {
+    const QPointF center(svgTools::normLength(attrs["cx"]), svgTools::normLength(attrs["cy"]));
+    auto shape = std::make_shared<shapes::ellipse>();
+    shape->setCenter(center);
+    /// A negative radius is an error, it disables the rendering of the element.
+    shape->setRadius(std::max(svgTools::normLength(rx), 0.0), std::max(svgTools::normLength(ry), 0.0));
+    return shape;
+}
+
+std::shared_ptr<shapes::ellipse> eellipse::ellipseShape() const {
+    return std::static_pointer_cast<shapes::ellipse>(mShape);
+}
+
+void eellipse::setCenter(const QPointF &center) {
+    if(ellipseShape()->center() == center) return;
+    ellipseShape()->setCenter(center);
+
+    notify(&eellipse::geometryChanged);
+    notify(&element::updated);
+}
+
+void eellipse::setRadius(qreal rx, qreal ry) {
+    const QSizeF radius(std::max(rx, 0.0), std::max(ry, 0.0));
+    if(ellipseShape()->radius() == radius) return;
+    ellipseShape()->setRadius(radius);
+
+    notify(&eellipse::geometryChanged);
+    notify(&element::updated);
+}
+
+void eellipse::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    QPointF center(cx(), cy());
+    if(attrs.contains("cx")) center.setX(svgTools::normLength(attrs["cx"].toString()));
+    if(attrs.contains("cy")) center.setY(svgTools::normLength(attrs["cy"].toString()));
+    setCenter(center);
+    setRadius(attrs.contains("rx") ? svgTools::normLength(attrs["rx"].toString()) : rx(),
+              attrs.contains("ry") ? svgTools::normLength(attrs["ry"].toString()) : ry());
+
+    graphic::setAttributes(tools::filter(attrs, mainAttrs()));
+}
+
+ecircle::ecircle(const utils::attributeList &attrs, QObject *parent)
+    : eellipse{shapeFrom(attrs), attrs, parent} {
+    dropAttributes({"r"});
+}
+
+ecircle::ecircle(const std::shared_ptr<shapes::ellipse> &shape, const utils::attributeList &attrs, QObject *parent)
+    : eellipse{shape, attrs, parent} {
+    dropAttributes({"r"});
+}
+
+std::shared_ptr<shapes::ellipse> ecircle::shapeFrom(const utils::attributeList &attrs) {
+    /// The radius of a circle is given to the ellipse as both of its radiuses.
+    return eellipse::shapeFrom(attrs, attrs["r"], attrs["r"]);
+}
+
+void ecircle::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    if(attrs.contains("r")) setR(svgTools::normLength(attrs["r"].toString()));
+
+    eellipse::setAttributes(tools::filter(attrs, {"r", "rx", "ry"}));
+}
+}
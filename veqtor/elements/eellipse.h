@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+
+#include <memory>
+
+#include "../shapes/shapes.h"
+#include "graphic.h"
+
+namespace veqtor::elements {
+/**
+ * @brief The eellipse class
+ * @abstract The `<ellipse>` element. Its geometry is kept as a `shapes::ellipse`, so it's painted with the
+ *  ellipse primitive and hit-tested with the ellipse equation instead of through a path.
+ */
+class eellipse: public graphic {
+    Q_OBJECT
+    Q_PROPERTY(qreal cx READ cx WRITE setCx NOTIFY geometryChanged)
+    Q_PROPERTY(qreal cy READ cy WRITE setCy NOTIFY geometryChanged)
+    Q_PROPERTY(qreal rx READ rx WRITE setRx NOTIFY geometryChanged)
+    Q_PROPERTY(qreal ry READ ry WRITE setRy NOTIFY geometryChanged)
+public:
+    eellipse(const utils::attributeList &attrs, QObject *parent = nullptr);
+    eellipse(QObject *parent = nullptr): eellipse{{}, parent} {}
+    /** @brief eellipse, An element around an ellipse that is already built (e.g. the shape of a scene node). */
+    eellipse(const std::shared_ptr<shapes::ellipse> &shape, const utils::attributeList &attrs, QObject *parent);
+
+    /** @brief shapeFrom, The ellipse of the `cx`, `cy`, `rx` and `ry` attributes. */
+    static std::shared_ptr<shapes::ellipse> shapeFrom(const utils::attributeList &attrs);
+    std::shared_ptr<shapes::ellipse> ellipseShape() const;
+    Type type() const override { return Type::Ellipse; }
+
+    qreal cx() const { return ellipseShape()->center().x(); }
+    qreal cy() const { return ellipseShape()->center().y(); }
+    qreal rx() const { return ellipseShape()->radius().width(); }
+    qreal ry() const { return ellipseShape()->radius().height(); }
+
+    void setCenter(const QPointF &center);
+    void setCx(qreal cx) { setCenter({cx, cy()}); }
+    void setCy(qreal cy) { setCenter({cx(), cy}); }
+    void setRadius(qreal rx, qreal ry);
+    void setRx(qreal rx) { setRadius(rx, ry()); }
+    void setRy(qreal ry) { setRadius(rx(), ry); }
+    void setAttributes(const QVariantMap &attrs) override;
+
+protected:
+    /** @brief shapeFrom, The ellipse of the `cx` and `cy` attributes and the given radiuses. */
+    static std::shared_ptr<shapes::ellipse> shapeFrom(const utils::attributeList &attrs,
+                                                      const QString &rx, const QString &ry);
+
+private:
+    static QStringList mainAttrs() { return {"cx", "cy", "rx", "ry"}; }
+
+signals:
+    void geometryChanged();
+};
+
+/**
+ * @brief The ecircle class
+ * @abstract The `<circle>` element, an ellipse with the same radius on both axes.
+ */
+class ecircle final: public eellipse {
+    Q_OBJECT
+    Q_PROPERTY(qreal r READ r WRITE setR NOTIFY geometryChanged)
+public:
+    ecircle(const utils::attributeList &attrs, QObject *parent = nullptr);
+    ecircle(QObject *parent = nullptr): ecircle{{}, parent} {}
+    ecircle(const std::shared_ptr<shapes::ellipse> &shape, const utils::attributeList &attrs, QObject *parent);
+
+    /** @brief shapeFrom, The ellipse of the `cx`, `cy` and `r` attributes. */
+    static std::shared_ptr<shapes::ellipse> shapeFrom(const utils::attributeList &attrs);
+
+    Type type() const override { return Type::Circle; }
+
+    qreal r() const { return rx(); }
+    void setR(qreal r) { setRadius(r, r); }
+    void setAttributes(const QVariantMap &attrs) override;
+};
+}
@@ -3,31 +3,99 @@
 #include "element.h"
 #include "container.h"
 #include "graphic.h"
+#include "../scene.h"
 #include "../utils/csstools.h"
 
 namespace veqtor::elements {
 using utils::tools;
 using utils::cssTools;
 
-element::element(QObject *parent, QMap<QString, QString> attrs)
+element::element(QObject *parent, const utils::attributeList &attrs)
     : QObject{parent}, mOpacity{attrs.value("opacity", "1.0").toFloat()},
       mId(attrs["id"]), mClass{attrs["class"].split(" ")},
       mStyle{cssTools::cssStyleParser(attrs["style"])},
-      mTabIndex{attrs["tab-index"].toLongLong()} {
-    auto map = tools::filter(attrs, mainAttrs());
-    for(const auto &key: map) {
-        mAttributes.insert(key, attrs[key]);
-    }
+      mTransforms(utils::transformStack::parse(attrs["transform"])),
+      mTransformBuff(mTransforms.matrix()),
+      mTabIndex{attrs["tab-index"].toLongLong()}, mAttributes(attrs) {
+    /// The list is copied once, each constructor drops the attributes that it has turned into properties.
+    dropAttributes(mainAttrs());
 }
 
 QString element::id() const { return mId; }
 
+QQmlPropertyMap *element::attributes() {
+    if(mAttributesView) return mAttributesView;
+
+    mAttributesView = new QQmlPropertyMap(this);
+    for(int i = 0; i < mAttributes.size(); ++i) {
+        mAttributesView->insert(mAttributes.name(i), mAttributes.valueAt(i));
+    }
+    /// `valueChanged` is only emitted for the changes of QML.
+    connect(mAttributesView, &QQmlPropertyMap::valueChanged, this, [this](const QString &key, const QVariant &value) {
+        mAttributes.insert(key, value.toString());
+    });
+    return mAttributesView;
+}
+
+const QTransform &element::worldTransform() const {
+    if(mScene) return mScene->world(mNode);
+    if(!mWorldValid) {
+        const element *parent = parentElement();
+        mWorldTransform = parent ? mTransformBuff * parent->worldTransform() : mTransformBuff;
+        mWorldOpacity = parent ? mOpacity * parent->worldOpacity() : mOpacity;
+        mWorldValid = true;
+    }
+    return mWorldTransform;
+}
+
+qreal element::worldOpacity() const {
+    if(mScene) return mScene->worldOpacity(mNode);
+    worldTransform();
+    return mWorldOpacity;
+}
+
+void element::invalidateWorld() {
+    mWorldValid = false;
+    invalidateChildren();
+}
+
+void element::bind(core::scene *scene, int node) {
+    mScene = scene;
+    mNode = node;
+}
+
+void element::unbind() {
+    mScene = nullptr;
+    mNode = -1;
+    mWorldValid = false;
+}
+
+void element::updateTransform() {
+    mTransformBuff = mTransforms.matrix(mOrigin);
+    if(mScene) mScene->setTransform(mNode, mTransformBuff);
+    invalidateWorld();
+
+    notify(&element::transformChanged);
+    notify(&element::updated);
+}
+
+void element::setOpacity(qreal _opacity) {
+    if(qFuzzyCompare(mOpacity, _opacity)) return;
+    mOpacity = _opacity;
+    if(mScene) mScene->setOpacity(mNode, mOpacity);
+    invalidateWorld();
+
+    notify(&element::opacityChanged);
+    notify(&element::updated);
+}
+
 void element::setId(const QString &idValue) {
     if(mId == idValue) return;
     mId = idValue;
+    if(mScene) mScene->setId(mNode, mId);
 
-    emit idChanged();
-    emit updated();
+    notify(&element::idChanged);
+    notify(&element::updated);
 }
 
 void element::setAttribute(const QString &key, const QString &value) {
@@ -38,20 +106,63 @@ void element::setAttributes(const QVariantMap &attrs) {
     /// TODO: Use a better method.
     if(attrs.contains("class")) mClass = attrs["class"].toStringList();
     if(attrs.contains("tab-index")) mTabIndex = attrs["tab-index"].toLongLong();
-    if(attrs.contains("opacity")) mOpacity = attrs["opacity"].toFloat();
+    if(attrs.contains("opacity")) setOpacity(attrs["opacity"].toFloat());
     if(attrs.contains("style")) {
         mStyle = utils::cssTools::cssStyleParser(attrs["style"].toString());
     }
+    if(attrs.contains("transform")) {
+        /// Either an SVG transform string or the QML list form.
+        const QVariant &value = attrs["transform"];
+        if(value.userType() == QMetaType::QString) {
+            setTransforms(utils::transformStack::parse(value.toString()));
+        } else {
+            QList<QVariantMap> list;
+            for(const QVariant &t: value.toList()) list.append(t.toMap());
+            setTransform(list);
+        }
+    }
 
-    auto filtred = tools::filter(attrs, mainAttrs());
+    const QStringList main = mainAttrs();
+    for(auto i = attrs.keyValueBegin(); i != attrs.keyValueEnd(); i++) {
+        if(main.contains(i->first)) continue;
+        if(i->second.isNull()) {
+            mAttributes.remove(i->first);
+            if(mAttributesView) mAttributesView->clear(i->first);
+        } else {
+            mAttributes.insert(i->first, i->second.toString());
+            if(mAttributesView) mAttributesView->insert(i->first, i->second);
+        }
+    }
+
+    notify(&element::attributesChanged);
+    notify(&element::updated);
+}
 
-    for(auto i = filtred.keyValueBegin(); i != filtred.keyValueEnd(); i++) {
-        if(i->second.isNull()) mAttributes.clear(i->first);
-        else mAttributes.insert(i->first, i->second);
+void element::endUpdate() {
+    if(!mUpdateDepth) {
+        qWarning("Veqtor: endUpdate is called without beginUpdate.");
+        return;
     }
+    if(--mUpdateDepth) return;
 
-    emit attributesChanged();
-    emit updated();
+    /// The handlers can change the element again, so the recorded signals are taken out first.
+    std::vector<int> indices;
+    indices.swap(mPendingSignals);
+    const int updatedIndex = QMetaMethod::fromSignal(&element::updated).methodIndex();
+    for(const int index: indices) {
+        if(index != updatedIndex) metaObject()->method(index).invoke(this, Qt::DirectConnection);
+    }
+    if(std::find(indices.begin(), indices.end(), updatedIndex) != indices.end()) emit updated();
+}
+
+void element::batch(const QJSValue &callback) {
+    if(!callback.isCallable()) {
+        qWarning("Veqtor: batch expects a function.");
+        return;
+    }
+    updateScope scope(this);
+    const QJSValue result = callback.call();
+    if(result.isError()) qWarning() << "Veqtor: batch error:" << result.toString();
 }
 
 QDebug &operator << (QDebug &debug, const element &el) {
@@ -3,16 +3,25 @@
 #include <QHash>
 #include <QObject>
 #include <QString>
+#include <QJSValue>
+#include <QMetaMethod>
 #include <QVariantMap>
 #include <QQmlPropertyMap>
 #include <QQuickTransform>
 
 #include <memory>
 #include <vector>
+#include <algorithm>
 #include <functional>
 
 #include "../nanopen.h"
 #include "../shapes/shapes.h"
+#include "../utils/attributelist.h"
+#include "../utils/transformstack.h"
+
+namespace veqtor::core {
+class scene;
+}
 
 namespace veqtor::elements {
 class element : public QObject {
@@ -30,13 +39,14 @@ public:
         Line,    Path,    Rect,
         Circle,  Ellipse, Polyline,
         Polygon, Text,    TextPath,
+        Series,
         /// Container
         Container = 0x100,
         SVG, Group, Link,
     };
     Q_ENUM(Type)
 
-    element(QObject *parent = nullptr, QMap<QString, QString> attrs = {});
+    element(QObject *parent = nullptr, const utils::attributeList &attrs = {});
 
     /// virtual members
     virtual Type type() const = 0;
@@ -50,7 +60,14 @@ public:
     friend QDebug &operator << (QDebug &debug, const QPointer<element> &el);
 
     QString id() const;
-    QQmlPropertyMap *attributes() { return &mAttributes; }
+    /**
+     * @brief attributes
+     * @abstract The QML view of the other attributes (the ones that are not properties of the element).
+     *  It's created on the first read, the values that QML writes to it are kept in the attribute list too.
+     */
+    QQmlPropertyMap *attributes();
+    /** @brief attributeValues, The other attributes, without the QML view. */
+    const utils::attributeList &attributeValues() const { return mAttributes; }
 
     void setId(const QString &idValue);
     void setAttribute(const QString &key, const QString &value);
@@ -61,52 +78,133 @@ public:
      */
     virtual void setAttributes(const QVariantMap &attrs);
 
-    QList<QVariantMap> transform() const { return mTransform; }
+    /**
+     * @brief transform
+     * @abstract Compatibility (QML) form of the transform list, e.g. `[{t: "rotate", angle: 45}, {t: "translate", x: 10, y: 0}]`.
+     *  Use `transforms()` or the per-operation setters for frequent changes.
+     */
+    QList<QVariantMap> transform() const { return mTransforms.toVariant(); }
     void setTransform(const QList<QVariantMap> &transforms) {
-        if (mTransform == transforms) return;
-
-        mTransform = transforms;
-        mTransformBuff.reset();
-        mTransformBuff.translate(mOrigin.x(), mOrigin.y());
-
-        for(const auto &t: qAsConst(mTransform)) {
-            if(t["t"] == "rotate") {
-                Qt::Axis axis = t["axis"].isNull() ? Qt::ZAxis : Qt::Axis(t["axis"].toInt());
-                mTransformBuff.rotate(t["angle"].toDouble(), axis);
-            } else if(t["t"] == "scale") {
-                mTransformBuff.scale(t["x"].toDouble(), t["y"].toDouble());
-            } else if(t["t"] == "shear") {
-                mTransformBuff.shear(t["h"].toDouble(), t["v"].toDouble());
-            } else if(t["t"] == "translate") {
-                mTransformBuff.translate(t["x"].toDouble(), t["y"].toDouble());
-            }
-        }
-        mTransformBuff.translate(-mOrigin.x(), -mOrigin.y());
+        setTransforms(utils::transformStack::fromVariant(transforms));
+    }
 
-        emit transformChanged();
-        emit updated();
+    const utils::transformStack &transforms() const { return mTransforms; }
+    void setTransforms(const utils::transformStack &transforms) {
+        if(mTransforms == transforms) return;
+        mTransforms = transforms;
+        updateTransform();
+    }
+
+    /**
+     * @brief setRotation, setTranslation, setScale, setShear
+     * @abstract Change the operation at @a index of the transform list in place,
+     *  only the operations after it are recomposed. Nothing changes if the operation is of another kind.
+     */
+    Q_INVOKABLE void setRotation(int index, qreal angle) {
+        if(mTransforms.setRotation(index, angle)) updateTransform();
+    }
+    Q_INVOKABLE void setTranslation(int index, const QPointF &offset) {
+        if(mTransforms.setTranslation(index, offset)) updateTransform();
+    }
+    Q_INVOKABLE void setScale(int index, qreal sx, qreal sy) {
+        if(mTransforms.setScale(index, sx, sy)) updateTransform();
+    }
+    Q_INVOKABLE void setShear(int index, qreal sh, qreal sv) {
+        if(mTransforms.setShear(index, sh, sv)) updateTransform();
     }
 
     QPointF origin() const { return mOrigin; }
     void setOrigin(QPointF o) {
         if(mOrigin == o) return;
         mOrigin = o;
+        updateTransform();
 
-        emit originChanged();
-        emit updated();
+        notify(&element::originChanged);
     }
 
     qreal opacity() const { return mOpacity; }
-    virtual void setOpacity(qreal _opacity) {
-        if(qFuzzyCompare(mOpacity, _opacity)) return;
-        mOpacity = _opacity;
+    virtual void setOpacity(qreal _opacity);
+
+    /**
+     * @brief worldTransform
+     * @abstract The transform from the element coordinates to the root coordinates (its own transform
+     *  followed by the transforms of its ancestors). It's cached until the element or an ancestor changes.
+     */
+    const QTransform &worldTransform() const;
+    /** @brief worldOpacity, The opacity of the element multiplied by the opacities of its ancestors (cached). */
+    qreal worldOpacity() const;
+
+    /**
+     * @brief invalidateWorld
+     * @abstract Drops the cached world transform and opacity of the element and its subtree.
+     *  Descendants are notified with their `updated` signal.
+     */
+    void invalidateWorld();
+
+    /**
+     * @brief bind, unbind
+     * @abstract A bound element is the QML view of a node of a `core::scene`: its world state is read from the
+     *  scene, and its transform, opacity and id are written through to the node. The scene creates the elements
+     *  on demand and binds them, and unbinds them when it's deleted.
+     */
+    virtual void bind(core::scene *scene, int node);
+    virtual void unbind();
+    /** @return The scene of a bound element, otherwise nullptr. */
+    core::scene *scene() const { return mScene; }
+    /** @return The node index of a bound element, otherwise -1. */
+    int node() const { return mNode; }
 
-        emit opacityChanged();
-        emit updated();
+    /**
+     * @brief beginUpdate, endUpdate
+     * @abstract Batch the changes of the element. While a batch is open, `updated` and the property change
+     *  signals are recorded instead of emitted, and each recorded signal is emitted once (`updated` last)
+     *  when the outermost batch ends, so the element is re-resolved and repainted once for all of the changes.
+     *  Batches can be nested.
+     */
+    Q_INVOKABLE void beginUpdate() { ++mUpdateDepth; }
+    Q_INVOKABLE void endUpdate();
+    /** @brief batch, Calls the QML function @a callback inside a batch. */
+    Q_INVOKABLE void batch(const QJSValue &callback);
+    bool updating() const { return mUpdateDepth > 0; }
+
+    /** @brief The updateScope class, a batch that ends when the scope ends. */
+    class updateScope {
+    public:
+        explicit updateScope(element *el): mElement(el) { mElement->beginUpdate(); }
+        ~updateScope() { mElement->endUpdate(); }
+        updateScope(const updateScope&) = delete;
+        updateScope &operator = (const updateScope&) = delete;
+
+    private:
+        element *mElement;
+    };
+
+protected:
+    /// Invalidates the world state of the children, containers override it.
+    virtual void invalidateChildren() {}
+    /// Recomposes the local transform from the transform list and the origin.
+    void updateTransform();
+    /**
+     * @brief notify
+     * @abstract Emits the parameterless @a signal of the element, or records it if a batch is open.
+     */
+    template<class T> void notify(void (T::*signal)()) {
+        if(!mUpdateDepth) {
+            emit (static_cast<T *>(this)->*signal)();
+            return;
+        }
+        const int index = QMetaMethod::fromSignal(signal).methodIndex();
+        if(std::find(mPendingSignals.begin(), mPendingSignals.end(), index) == mPendingSignals.end()) {
+            mPendingSignals.push_back(index);
+        }
     }
+    /** @return The parent element, or nullptr for the root. */
+    element *parentElement() const { return qobject_cast<element *>(parent()); }
+    /** @brief dropAttributes, Removes the attributes that a constructor has turned into properties. */
+    void dropAttributes(const QStringList &names) { mAttributes.remove(names); }
 
 private:
-    static QStringList mainAttrs() { return {"id","class","style","tab-index","opacity"}; }
+    static QStringList mainAttrs() { return {"id","class","style","tab-index","opacity","transform"}; }
 
 signals:
     void updated();
@@ -123,12 +221,30 @@ protected:
     QStringList mClass;
     QHash<QString, QString> mStyle;
 
-    QList<QVariantMap> mTransform;
+    utils::transformStack mTransforms;
     QTransform mTransformBuff;
     QPointF mOrigin;
 
+    /// World state cache, it's valid only if the caches of all of the ancestors are valid too.
+    mutable QTransform mWorldTransform;
+    mutable qreal mWorldOpacity = 1.0;
+    mutable bool mWorldValid = false;
+
     long long mTabIndex;
 
-    QQmlPropertyMap mAttributes;
+    utils::attributeList mAttributes;
+    QQmlPropertyMap *mAttributesView = nullptr;
+
+    /// The scene and the node of a bound element.
+    core::scene *mScene = nullptr;
+    int mNode = -1;
+
+private:
+    /// Containers notify their children when their world state changes.
+    friend class container;
+
+    /// Depth of the open batches, and the method indices of the signals that are recorded in them.
+    int mUpdateDepth = 0;
+    std::vector<int> mPendingSignals;
 };
 }
@@ -0,0 +1,40 @@
+#include "eline.h"
+
+namespace veqtor::elements {
+using utils::tools;
+
+eline::eline(const utils::attributeList &attrs, QObject *parent)
+    : eline{shapeFrom(attrs), attrs, parent} {}
+
+eline::eline(const std::shared_ptr<shapes::line> &shape, const utils::attributeList &attrs, QObject *parent)
+    : graphic{shape, parent, attrs} {
+    dropAttributes(mainAttrs());
+}
+
+std::shared_ptr<shapes::line> eline::shapeFrom(const utils::attributeList &attrs) {
+    auto shape = std::make_shared<shapes::line>();
+    shape->setLine({svgTools::normLength(attrs["x1"]), svgTools::normLength(attrs["y1"]),
+                    svgTools::normLength(attrs["x2"]), svgTools::normLength(attrs["y2"])});
+    return shape;
+}
+
+void eline::setLine(const QLineF &line) {
+    if(this->line() == line) return;
+    lineShape()->setLine(line);
+
+    notify(&eline::geometryChanged);
+    notify(&element::updated);
+}
+
+void eline::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    QLineF l = line();
+    if(attrs.contains("x1")) l.setP1({svgTools::normLength(attrs["x1"].toString()), l.y1()});
+    if(attrs.contains("y1")) l.setP1({l.x1(), svgTools::normLength(attrs["y1"].toString())});
+    if(attrs.contains("x2")) l.setP2({svgTools::normLength(attrs["x2"].toString()), l.y2()});
+    if(attrs.contains("y2")) l.setP2({l.x2(), svgTools::normLength(attrs["y2"].toString())});
+    setLine(l);
+
+    graphic::setAttributes(tools::filter(attrs, mainAttrs()));
+}
+}
@@ -8,17 +8,44 @@
 #include "graphic.h"
 
 namespace veqtor::elements {
+/**
+ * @brief The eline class
+ * @abstract The `<line>` element. It's painted as a single segment and hit-tested by its distance to the segment.
+ */
 class eline final: public graphic {
     Q_OBJECT
+    Q_PROPERTY(qreal x1 READ x1 WRITE setX1 NOTIFY geometryChanged)
+    Q_PROPERTY(qreal y1 READ y1 WRITE setY1 NOTIFY geometryChanged)
+    Q_PROPERTY(qreal x2 READ x2 WRITE setX2 NOTIFY geometryChanged)
+    Q_PROPERTY(qreal y2 READ y2 WRITE setY2 NOTIFY geometryChanged)
 public:
-    explicit eline(QObject *parent = nullptr): graphic{parent} {
-        mShape = std::make_shared<shapes::line>();
-    }
+    eline(const utils::attributeList &attrs, QObject *parent = nullptr);
+    explicit eline(QObject *parent = nullptr): eline{{}, parent} {}
+    /** @brief eline, An element around a segment that is already built (e.g. the shape of a scene node). */
+    eline(const std::shared_ptr<shapes::line> &shape, const utils::attributeList &attrs, QObject *parent);
 
-    std::shared_ptr<shapes::line> lineShape() { return std::dynamic_pointer_cast<shapes::line>(mShape); }
+    /** @brief shapeFrom, The segment of the `x1`, `y1`, `x2` and `y2` attributes. */
+    static std::shared_ptr<shapes::line> shapeFrom(const utils::attributeList &attrs);
+    std::shared_ptr<shapes::line> lineShape() const { return std::static_pointer_cast<shapes::line>(mShape); }
     Type type() const override { return Type::Line; }
-    void setAttributes(const QVariantMap &attrs) override { Q_UNUSED(attrs); }
-signals:
+
+    QLineF line() const { return *lineShape(); }
+    qreal x1() const { return lineShape()->x1(); }
+    qreal y1() const { return lineShape()->y1(); }
+    qreal x2() const { return lineShape()->x2(); }
+    qreal y2() const { return lineShape()->y2(); }
+
+    void setLine(const QLineF &line);
+    void setX1(qreal x1) { setLine({x1, y1(), x2(), y2()}); }
+    void setY1(qreal y1) { setLine({x1(), y1, x2(), y2()}); }
+    void setX2(qreal x2) { setLine({x1(), y1(), x2, y2()}); }
+    void setY2(qreal y2) { setLine({x1(), y1(), x2(), y2}); }
+    void setAttributes(const QVariantMap &attrs) override;
+
 private:
+    static QStringList mainAttrs() { return {"x1", "y1", "x2", "y2"}; }
+
+signals:
+    void geometryChanged();
 };
 }
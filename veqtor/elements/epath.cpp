@@ -4,10 +4,10 @@
 namespace veqtor::elements {
 using utils::tools;
 
-epath::epath(const QMap<QString, QString> &attrs, QObject *parent, const shapes::path &p)
-    : graphic{std::make_shared<shapes::path>(p), parent, tools::filter(attrs, mainAttrs())},
-      mData{attrs["d"]} {
+epath::epath(const utils::attributeList &attrs, QObject *parent, const shapes::path &p)
+    : graphic{std::make_shared<shapes::path>(p), parent, attrs}, mData{attrs["d"]} {
     pathShape()->setPathData(svgTools::svgPathParser(mData));
+    dropAttributes(mainAttrs());
 }
 
 epath::epath(const QString &d, QObject *parent)
@@ -16,7 +16,20 @@ epath::epath(const QString &d, QObject *parent)
 epath::epath(const shapes::path &pathObject, QObject *parent)
     : epath{{}, parent, pathObject} {}
 
+epath::epath(const std::shared_ptr<shapes::path> &shape, const utils::attributeList &attrs, QObject *parent)
+    : graphic{shape, parent, attrs} {
+    dropAttributes(mainAttrs());
+}
+
+std::shared_ptr<shapes::path> epath::shapeFrom(const utils::attributeList &attrs) {
+    auto shape = std::make_shared<shapes::path>();
+    shape->setPathData(svgTools::svgPathParser(attrs["d"]));
+    return shape;
+}
+
 std::shared_ptr<shapes::path> epath::pathShape() {
+    /// The path maps the new points through the world transform, so the lazy cache is validated first.
+    worldTransform();
     return std::dynamic_pointer_cast<shapes::path>(mShape);
 }
 
@@ -24,13 +37,18 @@ std::shared_ptr<shapes::path> epath::pathShape() const {
     return std::dynamic_pointer_cast<shapes::path>(mShape);
 }
 
+QString epath::data() const {
+    if(mData.isNull()) mData = svgTools::svgPathString(*pathShape());
+    return mData;
+}
+
 void epath::setData(const QString &d) {
-    if(mData == d) return;
+    if(data() == d) return;
     mData = d;
     pathShape()->setPathData(svgTools::svgPathParser(mData));
 
-    emit dataChanged();
-    emit updated();
+    notify(&epath::dataChanged);
+    notify(&element::updated);
 }
 
 void epath::setAttributes(const QVariantMap &attrs) {
@@ -48,58 +66,59 @@ QVariantMap epath::at(long long index) const {
 QVariantMap epath::shift() {
     auto pd = at(0);
     pathShape()->leftShift();
-    emit updated();
+    notify(&element::updated);
     return pd;
 }
 
 void epath::close() {
 	pathShape()->close();
-	emit updated();
+	notify(&element::updated);
 }
 
 void epath::vTo(qreal y, bool rel) {
     pathShape()->vTo(y, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::hTo(qreal x, bool rel) {
     pathShape()->hTo(x, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::moveTo(QPointF to, bool rel) {
     pathShape()->moveTo(to, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::lineTo(QPointF to, bool rel) {
     pathShape()->lineTo(to, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::quadTo(const QPointF &c, const QPointF &to, bool rel) {
     pathShape()->quadTo(c, to, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::cubicTo(const QPointF &c1, const QPointF &c2, const QPointF &to, bool rel) {
     pathShape()->cubicTo(c1, c2, to, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::arcTo(QPointF to, QSizeF radius, qreal xrot, bool larc, bool sweep, bool rel) {
     pathShape()->arcTo(to, radius, xrot, larc, sweep, rel);
-    emit updated();
+    notify(&element::updated);
 }
 
 void epath::pop() {
     pathShape()->pop();
-    emit pointsChanged(size() -1);
-    emit updated();
+    /// The index is only meaningful for a single change, so it's not recorded in a batch.
+    if(!updating()) emit pointsChanged(size() -1);
+    notify(&element::updated);
 }
 
 void epath::push(char type, const QPointF &to, const QVariantMap &data, bool relative) {
     pathShape()->push(type, to, data, relative);
-    emit updated();
+    notify(&element::updated);
 }
 }
@@ -14,14 +14,19 @@ class epath: public graphic {
     Q_OBJECT
     Q_PROPERTY(QString d READ data WRITE setData NOTIFY dataChanged)
 public:
-    epath(const QMap<QString, QString>& attrs, QObject* parent = nullptr, const shapes::path& p = shapes::path());
+    epath(const utils::attributeList& attrs, QObject* parent = nullptr, const shapes::path& p = shapes::path());
     epath(const QString& d, QObject* parent = nullptr);
     epath(const shapes::path& pathObject, QObject* parent = nullptr);
+    /** @brief epath, An element around a path that is already built (e.g. the shape of a scene node). */
+    epath(const std::shared_ptr<shapes::path>& shape, const utils::attributeList& attrs, QObject* parent);
     epath(QObject* parent = nullptr): epath{"", parent} {}
 
+    /** @brief shapeFrom, The path of the `d` attribute. */
+    static std::shared_ptr<shapes::path> shapeFrom(const utils::attributeList &attrs);
     std::shared_ptr<shapes::path> pathShape();
     std::shared_ptr<shapes::path> pathShape() const;
-    QString data() const { return mData; }
+    /** @return The `d` attribute, it's generated from the path if the element is created around one. */
+    QString data() const;
     Type type() const override { return Type::Path; }
 
     void setData(const QString &d);
@@ -44,7 +49,7 @@ public slots:
     void pop();
     void clear() {
         pathShape()->clear();
-        emit updated();
+        notify(&element::updated);
     }
 
     /**
@@ -63,6 +68,7 @@ public slots:
 
     /**
      * @abstract Set a new value for the path data at the given index.
+     *  A relative value is resolved from the previous segment, the other segments don't move.
      * @param index, Index of the path data in the vector. If the given value is out of range, nothing will change.
      * @param data, Path data value in the form of a structure {type: `char`, to: `point`, data: `Object`, relative: `bool` }.
      * @list
@@ -77,22 +83,23 @@ public slots:
      */
     void set(long long index, const QVariantMap &data) {
         if(index < size()) {
-            pathShape()->at(index) = shapes::pathdata(data);
-            emit updated();
+            pathShape()->set(index, shapes::pathdata(data));
+            notify(&element::updated);
         }
     }
     void set(long long index, const QPointF &to) {
         if(index < size()) {
-            pathShape()->at(index).to = to;
-            emit updated();
+            pathShape()->setPoint(index, to);
+            notify(&element::updated);
         }
     }
     void set(const QList<QPointF> &pointSeries, long long start = 0,
              long long end = std::numeric_limits<long long>::max()) {
-        for(size_t i = start; i < std::min<long long>({size(), end, pointSeries.size()}); ++i) {
-            pathShape()->at(i).to = pointSeries[i];
+        const long long last = std::min<long long>({size(), end, pointSeries.size()});
+        if(start >= 0 && start < last) {
+            pathShape()->setPoints(start, last, pointSeries);
+            notify(&element::updated);
         }
-        if(start < size() && start < end) emit updated();
     }
 
 private:
@@ -103,6 +110,7 @@ signals:
     void pointsChanged(size_t index);
 
 private:
-    QString mData;
+    /// A null string is generated from the path on the first read.
+    mutable QString mData;
 };
 }
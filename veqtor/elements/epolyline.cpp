@@ -0,0 +1,74 @@
+#include "epolyline.h"
+
+namespace veqtor::elements {
+using utils::tools;
+
+epolyline::epolyline(const utils::attributeList &attrs, QObject *parent, bool closed)
+    : graphic{shapeFrom(attrs, closed), parent, attrs}, mPoints{attrs["points"]}, mClosed{closed} {
+    dropAttributes(mainAttrs());
+}
+
+epolyline::epolyline(const std::shared_ptr<shapes::path> &shape, const utils::attributeList &attrs,
+                     QObject *parent, bool closed)
+    : graphic{shape, parent, attrs}, mClosed{closed} {
+    dropAttributes(mainAttrs());
+}
+
+epolyline::epolyline(const utils::attributeList &attrs, QObject *parent)
+    : epolyline{attrs, parent, false} {}
+
+std::shared_ptr<shapes::path> epolyline::shapeFrom(const utils::attributeList &attrs, bool closed) {
+    auto shape = std::make_shared<shapes::path>();
+    shape->setPathData(pointsData(attrs["points"], closed));
+    return shape;
+}
+
+std::shared_ptr<shapes::path> epolyline::pathShape() const {
+    return std::static_pointer_cast<shapes::path>(mShape);
+}
+
+QString epolyline::points() const {
+    if(mPoints.isNull()) mPoints = pointsString(*pathShape());
+    return mPoints;
+}
+
+void epolyline::setPoints(const QString &points) {
+    if(this->points() == points) return;
+    mPoints = points;
+    updateShape();
+
+    notify(&epolyline::pointsChanged);
+    notify(&element::updated);
+}
+
+void epolyline::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    if(attrs.contains("points")) setPoints(attrs["points"].toString());
+
+    graphic::setAttributes(tools::filter(attrs, mainAttrs()));
+}
+
+shapes::pathbuffer epolyline::pointsData(const QString &points, bool closed) {
+    /// The points are built into a buffer first, so the bounds are computed once.
+    shapes::pathbuffer data;
+    const auto numbers = utils::pathTokenizer::parseNumbers(points);
+    /// An odd coordinate is an error, the points before it are still rendered.
+    const size_t count = numbers.size() / 2;
+    data.reserve(count + 1, 2 * count);
+    for(size_t i = 0; i < count; ++i) {
+        const apoint p(numbers[2 * i], numbers[2 * i + 1]);
+        i ? data.lineTo(p) : data.moveTo(p);
+    }
+    if(closed && count) data.close();
+    return data;
+}
+
+QString epolyline::pointsString(const shapes::path &path) {
+    QStringList points;
+    for(const shapes::pathbuffer::segment s: path) {
+        if(s.verb == shapes::pathbuffer::Close) continue;
+        points.append(QString::number(s.to().x()) + ',' + QString::number(s.to().y()));
+    }
+    return points.join(' ');
+}
+}
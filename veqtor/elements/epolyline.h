@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QObject>
+
+#include <memory>
+
+#include "../shapes/shapes.h"
+#include "graphic.h"
+
+namespace veqtor::elements {
+/**
+ * @brief The epolyline class
+ * @abstract The `<polyline>` element. Its points are kept as straight path segments, so they are painted and
+ *  hit-tested without curve flattening, and decimated like a series if `decimate` is enabled.
+ */
+class epolyline: public graphic {
+    Q_OBJECT
+    Q_PROPERTY(QString points READ points WRITE setPoints NOTIFY pointsChanged)
+public:
+    epolyline(const utils::attributeList &attrs, QObject *parent = nullptr);
+    epolyline(QObject *parent = nullptr): epolyline{{}, parent} {}
+    /** @brief epolyline, An element around a path that is already built (e.g. the shape of a scene node). */
+    epolyline(const std::shared_ptr<shapes::path> &shape, const utils::attributeList &attrs, QObject *parent)
+        : epolyline{shape, attrs, parent, false} {}
+
+    /** @brief shapeFrom, The path of the `points` attribute, it's closed for a polygon. */
+    static std::shared_ptr<shapes::path> shapeFrom(const utils::attributeList &attrs, bool closed);
+    std::shared_ptr<shapes::path> pathShape() const;
+    Type type() const override { return mClosed ? Type::Polygon : Type::Polyline; }
+
+    /** @return The `points` attribute, it's generated from the path if the element is created around one. */
+    QString points() const;
+    void setPoints(const QString &points);
+    void setAttributes(const QVariantMap &attrs) override;
+
+protected:
+    epolyline(const utils::attributeList &attrs, QObject *parent, bool closed);
+    epolyline(const std::shared_ptr<shapes::path> &shape, const utils::attributeList &attrs, QObject *parent,
+              bool closed);
+
+private:
+    static QStringList mainAttrs() { return {"points"}; }
+    static shapes::pathbuffer pointsData(const QString &points, bool closed);
+    static QString pointsString(const shapes::path &path);
+    void updateShape() { pathShape()->setPathData(pointsData(mPoints, mClosed)); }
+
+signals:
+    void pointsChanged();
+
+private:
+    /// A null string is generated from the path on the first read.
+    mutable QString mPoints;
+    bool mClosed = false;
+};
+
+/**
+ * @brief The epolygon class
+ * @abstract The `<polygon>` element, a polyline that is closed from its last point to the first one.
+ */
+class epolygon final: public epolyline {
+    Q_OBJECT
+public:
+    epolygon(const utils::attributeList &attrs, QObject *parent = nullptr): epolyline{attrs, parent, true} {}
+    epolygon(QObject *parent = nullptr): epolygon{{}, parent} {}
+    epolygon(const std::shared_ptr<shapes::path> &shape, const utils::attributeList &attrs, QObject *parent)
+        : epolyline{shape, attrs, parent, true} {}
+};
+}
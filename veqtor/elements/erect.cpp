@@ -0,0 +1,78 @@
+#include "erect.h"
+
+namespace veqtor::elements {
+using utils::tools;
+
+erect::erect(const utils::attributeList &attrs, QObject *parent)
+    : graphic{shapeFrom(attrs), parent, attrs},
+      mRect{svgTools::normLength(attrs["x"]), svgTools::normLength(attrs["y"]),
+            svgTools::normLength(attrs["width"]), svgTools::normLength(attrs["height"])} {
+    /// If only one of the radiuses is given, the other one is the same.
+    mRx = svgTools::normLength(attrs.value("rx", attrs["ry"]));
+    mRy = svgTools::normLength(attrs.value("ry", attrs["rx"]));
+    dropAttributes(mainAttrs());
+}
+
+erect::erect(const std::shared_ptr<shapes::rect> &shape, const utils::attributeList &attrs, QObject *parent)
+    : graphic{shape, parent, attrs}, mRect{*shape} {
+    /// The shape keeps the clamped radius of both axes.
+    mRx = mRy = shape->radiuses()[0];
+    dropAttributes(mainAttrs());
+}
+
+std::shared_ptr<shapes::rect> erect::shapeFrom(const utils::attributeList &attrs) {
+    auto shape = std::make_shared<shapes::rect>();
+    updateShape(*shape,
+                {svgTools::normLength(attrs["x"]), svgTools::normLength(attrs["y"]),
+                 svgTools::normLength(attrs["width"]), svgTools::normLength(attrs["height"])},
+                svgTools::normLength(attrs.value("rx", attrs["ry"])),
+                svgTools::normLength(attrs.value("ry", attrs["rx"])));
+    return shape;
+}
+
+std::shared_ptr<shapes::rect> erect::rectShape() const {
+    return std::static_pointer_cast<shapes::rect>(mShape);
+}
+
+void erect::setRect(const QRectF &rect) {
+    if(mRect == rect) return;
+    mRect = rect;
+    updateShape();
+
+    notify(&erect::geometryChanged);
+    notify(&element::updated);
+}
+
+void erect::setRadius(qreal rx, qreal ry) {
+    if(qFuzzyCompare(mRx, rx) && qFuzzyCompare(mRy, ry)) return;
+    mRx = rx;
+    mRy = ry;
+    updateShape();
+
+    notify(&erect::geometryChanged);
+    notify(&element::updated);
+}
+
+void erect::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    QRectF r = mRect;
+    if(attrs.contains("x")) r.moveLeft(svgTools::normLength(attrs["x"].toString()));
+    if(attrs.contains("y")) r.moveTop(svgTools::normLength(attrs["y"].toString()));
+    if(attrs.contains("width")) r.setWidth(svgTools::normLength(attrs["width"].toString()));
+    if(attrs.contains("height")) r.setHeight(svgTools::normLength(attrs["height"].toString()));
+    setRect(r);
+    setRadius(attrs.contains("rx") ? svgTools::normLength(attrs["rx"].toString()) : mRx,
+              attrs.contains("ry") ? svgTools::normLength(attrs["ry"].toString()) : mRy);
+
+    graphic::setAttributes(tools::filter(attrs, mainAttrs()));
+}
+
+void erect::updateShape(shapes::rect &shape, const QRectF &rect, qreal rx, qreal ry) {
+    /// A negative or zero size disables the rendering of the element.
+    const QRectF r = rect.width() > 0 && rect.height() > 0 ? rect : QRectF(rect.topLeft(), QSizeF());
+    shape.setRect(r);
+    /// NanoVG has no elliptical corners, so the smaller radius is used for both axes.
+    const qreal radius = std::min(std::clamp(rx, 0.0, r.width() / 2), std::clamp(ry, 0.0, r.height() / 2));
+    shape.setCornerRadius(static_cast<float>(radius));
+}
+}
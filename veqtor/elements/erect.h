@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QObject>
+
+#include <memory>
+
+#include "../shapes/shapes.h"
+#include "graphic.h"
+
+namespace veqtor::elements {
+/**
+ * @brief The erect class
+ * @abstract The `<rect>` element. Its geometry is kept as a `shapes::rect`, so it's painted with a single
+ *  (rounded) rectangle primitive and hit-tested analytically instead of through a path.
+ */
+class erect: public graphic {
+    Q_OBJECT
+    Q_PROPERTY(qreal x READ x WRITE setX NOTIFY geometryChanged)
+    Q_PROPERTY(qreal y READ y WRITE setY NOTIFY geometryChanged)
+    Q_PROPERTY(qreal width READ width WRITE setWidth NOTIFY geometryChanged)
+    Q_PROPERTY(qreal height READ height WRITE setHeight NOTIFY geometryChanged)
+    Q_PROPERTY(qreal rx READ rx WRITE setRx NOTIFY geometryChanged)
+    Q_PROPERTY(qreal ry READ ry WRITE setRy NOTIFY geometryChanged)
+public:
+    erect(const utils::attributeList &attrs, QObject *parent = nullptr);
+    erect(QObject *parent = nullptr): erect{{}, parent} {}
+    /** @brief erect, An element around a rect that is already built (e.g. the shape of a scene node). */
+    erect(const std::shared_ptr<shapes::rect> &shape, const utils::attributeList &attrs, QObject *parent);
+
+    /** @brief shapeFrom, The rect of the `x`, `y`, `width`, `height`, `rx` and `ry` attributes. */
+    static std::shared_ptr<shapes::rect> shapeFrom(const utils::attributeList &attrs);
+    std::shared_ptr<shapes::rect> rectShape() const;
+    Type type() const override { return Type::Rect; }
+
+    QRectF rect() const { return mRect; }
+    qreal x() const { return mRect.x(); }
+    qreal y() const { return mRect.y(); }
+    qreal width() const { return mRect.width(); }
+    qreal height() const { return mRect.height(); }
+    qreal rx() const { return mRx; }
+    qreal ry() const { return mRy; }
+
+    void setRect(const QRectF &rect);
+    void setX(qreal x) { setRect({x, y(), width(), height()}); }
+    void setY(qreal y) { setRect({x(), y, width(), height()}); }
+    void setWidth(qreal width) { setRect({x(), y(), width, height()}); }
+    void setHeight(qreal height) { setRect({x(), y(), width(), height}); }
+    void setRadius(qreal rx, qreal ry);
+    void setRx(qreal rx) { setRadius(rx, mRy); }
+    void setRy(qreal ry) { setRadius(mRx, ry); }
+    void setAttributes(const QVariantMap &attrs) override;
+
+private:
+    static QStringList mainAttrs() { return {"x", "y", "width", "height", "rx", "ry"}; }
+    /// Copies the geometry to the shape, the radiuses are clamped to half of the size.
+    static void updateShape(shapes::rect &shape, const QRectF &rect, qreal rx, qreal ry);
+    void updateShape() { updateShape(*rectShape(), mRect, mRx, mRy); }
+
+signals:
+    void geometryChanged();
+
+private:
+    QRectF mRect;
+    qreal mRx = 0.0;
+    qreal mRy = 0.0;
+};
+}
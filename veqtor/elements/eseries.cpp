@@ -0,0 +1,106 @@
+#include "eseries.h"
+
+namespace veqtor::elements {
+using utils::tools;
+
+eseries::eseries(const utils::attributeList &attrs, QObject *parent)
+    : eseries{shapeFrom(attrs), attrs, parent} {}
+
+eseries::eseries(const std::shared_ptr<shapes::series> &shape, const utils::attributeList &attrs, QObject *parent)
+    : graphic{shape, parent, attrs} {
+    dropAttributes(mainAttrs());
+}
+
+std::shared_ptr<shapes::series> eseries::shapeFrom(const utils::attributeList &attrs) {
+    return std::make_shared<shapes::series>(attrs.value("capacity", "1024").toUInt());
+}
+
+std::shared_ptr<shapes::series> eseries::seriesShape() const {
+    return std::static_pointer_cast<shapes::series>(mShape);
+}
+
+void eseries::setCapacity(int capacity) {
+    if(capacity < 0 || size_t(capacity) == seriesShape()->capacity()) return;
+    seriesShape()->setCapacity(capacity);
+    notify(&eseries::capacityChanged);
+    scheduleUpdate();
+}
+
+void eseries::setWindow(const QRectF &window) {
+    if(seriesShape()->window() == window) return;
+    seriesShape()->setWindow(window);
+    notify(&eseries::windowChanged);
+    scheduleUpdate();
+}
+
+void eseries::setViewport(const QRectF &viewport) {
+    if(seriesShape()->viewport() == viewport) return;
+    seriesShape()->setViewport(viewport);
+    notify(&eseries::viewportChanged);
+    scheduleUpdate();
+}
+
+void eseries::setAttributes(const QVariantMap &attrs) {
+    if(attrs.isEmpty()) return;
+    if(attrs.contains("capacity")) setCapacity(attrs["capacity"].toInt());
+
+    graphic::setAttributes(tools::filter(attrs, mainAttrs()));
+}
+
+void eseries::append(const float *xy, size_t count) {
+    seriesShape()->append(xy, count);
+    scheduleUpdate();
+}
+
+void eseries::append(const QPointF &point) {
+    seriesShape()->append(static_cast<float>(point.x()), static_cast<float>(point.y()));
+    scheduleUpdate();
+}
+
+void eseries::append(const QList<QPointF> &points) {
+    seriesShape()->append(points.constData(), points.size());
+    scheduleUpdate();
+}
+
+void eseries::appendPoints(const QVariantList &points) {
+    std::vector<float> xy;
+    xy.reserve(2 * points.size());
+    for(const QVariant &point: points) {
+        const QPointF p = point.toPointF();
+        xy.push_back(static_cast<float>(p.x()));
+        xy.push_back(static_cast<float>(p.y()));
+    }
+    append(xy.data(), points.size());
+}
+
+void eseries::appendBuffer(const QByteArray &buffer) {
+    append(reinterpret_cast<const float *>(buffer.constData()), buffer.size() / (2 * sizeof(float)));
+}
+
+int eseries::shift(int count) {
+    if(count <= 0) return 0;
+    const size_t removed = seriesShape()->shift(count);
+    if(removed) scheduleUpdate();
+    return static_cast<int>(removed);
+}
+
+void eseries::clear() {
+    seriesShape()->clear();
+    scheduleUpdate();
+}
+
+void eseries::scheduleUpdate() {
+    if(mUpdatePending) return;
+    mUpdatePending = true;
+    QMetaObject::invokeMethod(this, &eseries::flushUpdate, Qt::QueuedConnection);
+}
+
+void eseries::flushUpdate() {
+    mUpdatePending = false;
+    /// The bounding box is O(n), so it's only recomputed once for all of the coalesced changes.
+    seriesShape()->updateBoundingBox();
+
+    notify(&eseries::countChanged);
+    notify(&element::updated);
+}
+}
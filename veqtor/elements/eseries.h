@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+
+#include <memory>
+
+#include "../shapes/shapes.h"
+#include "graphic.h"
+
+namespace veqtor::elements {
+/**
+ * @brief The eseries class
+ * @abstract A streaming polyline element (`<series capacity="1024"/>`) for real-time plots.
+ *  Its points live in a ring buffer, and all changes made in one event loop iteration are reported
+ *  with a single `updated` signal, so the canvas repaints at most once per frame regardless of the sample rate.
+ */
+class eseries: public graphic {
+    Q_OBJECT
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(QRectF window READ window WRITE setWindow NOTIFY windowChanged)
+    Q_PROPERTY(QRectF viewport READ viewport WRITE setViewport NOTIFY viewportChanged)
+public:
+    eseries(const utils::attributeList &attrs, QObject *parent = nullptr);
+    eseries(QObject *parent = nullptr): eseries{{}, parent} {}
+    /** @brief eseries, An element around a series that is already built (e.g. the shape of a scene node). */
+    eseries(const std::shared_ptr<shapes::series> &shape, const utils::attributeList &attrs, QObject *parent);
+
+    /** @brief shapeFrom, An empty series with the `capacity` attribute. */
+    static std::shared_ptr<shapes::series> shapeFrom(const utils::attributeList &attrs);
+    std::shared_ptr<shapes::series> seriesShape() const;
+    Type type() const override { return Type::Series; }
+
+    int capacity() const { return static_cast<int>(seriesShape()->capacity()); }
+    int count() const { return static_cast<int>(seriesShape()->size()); }
+    QRectF window() const { return seriesShape()->window(); }
+    QRectF viewport() const { return seriesShape()->viewport(); }
+
+    void setCapacity(int capacity);
+    void setWindow(const QRectF &window);
+    void setViewport(const QRectF &viewport);
+    void setAttributes(const QVariantMap &attrs) override;
+
+    /**
+     * @brief append
+     * @abstract Appends packed x, y pairs in one block copy (C++ side).
+     * @param xy
+     * @param count, Number of points.
+     */
+    void append(const float *xy, size_t count);
+    void append(const QList<QPointF> &points);
+
+    Q_INVOKABLE void append(const QPointF &point);
+    /** @brief appendPoints, Appends an array of points in one call (QML side). */
+    Q_INVOKABLE void appendPoints(const QVariantList &points);
+    /**
+     * @brief appendBuffer
+     * @abstract Appends the points of an `ArrayBuffer` (e.g. `Float32Array.buffer`) of packed 32-bit float x, y pairs.
+     */
+    Q_INVOKABLE void appendBuffer(const QByteArray &buffer);
+    Q_INVOKABLE QPointF at(int index) const { return index >= 0 ? seriesShape()->at(index) : QPointF(); }
+    /**
+     * @brief shift
+     * @abstract Removes @a count points from the front of the series.
+     * @return Number of the removed points.
+     */
+    Q_INVOKABLE int shift(int count = 1);
+
+public slots:
+    void clear();
+
+private slots:
+    void flushUpdate();
+
+private:
+    static QStringList mainAttrs() { return {"capacity"}; }
+    /// Requests a single `updated` signal for all changes until the next event loop iteration.
+    void scheduleUpdate();
+
+signals:
+    void capacityChanged();
+    void countChanged();
+    void windowChanged();
+    void viewportChanged();
+
+private:
+    bool mUpdatePending = false;
+};
+}
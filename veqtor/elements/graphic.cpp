@@ -1,17 +1,21 @@
+#include <cmath>
+
 #include "graphic.h"
+#include "../scene.h"
 #include "../utils/svgtools.h"
 
 namespace veqtor::elements {
 
-graphic::graphic(const shape_sptr &sh, QObject *parent, const QMap<QString, QString> &attrs)
-    : element{parent, tools::filter(attrs, mainAttrs())}, mShape(sh) {
-    mShape->setTransform(&mTransformBuff);
-    mShape->setPen(core::nanoPen{
-        svgTools::normColor(attrs.value("fill", "black")).rgba(),
-        svgTools::normColor(attrs["stroke"]).rgba(),
-        svgTools::normSW(attrs["stroke-width"]),
-        static_cast<float>(mOpacity)
-    });
+graphic::graphic(const shape_sptr &sh, QObject *parent, const utils::attributeList &attrs)
+    : element{parent, attrs}, mShape(sh) {
+    dropAttributes(mainAttrs());
+    /// Shapes are hit-tested and bounded in the root coordinates.
+    mShape->setTransform(&mWorldTransform);
+    /// Pens are interned, so the elements of the same style share one entry.
+    mShape->setPen(parsePen(attrs));
+    mOwnCache.setDecimate(attrs.value("decimate") == "true");
+
+    connect(this, &element::updated, this, &graphic::onUpdated);
 }
 
 graphic::graphic(const shape_sptr &sh, QObject *parent): graphic{sh, parent, {}} {}
@@ -28,10 +32,66 @@ graphic::shape_sptr &graphic::shape() { return mShape; }
 
 core::nanoPen graphic::pen() const { return mShape->pen(); }
 
+core::nanoPen graphic::parsePen(const utils::attributeList &attrs) {
+    core::nanoPen pen{
+        svgTools::normColor(attrs.value("fill", "black")).rgba(),
+        svgTools::normColor(attrs["stroke"]).rgba(),
+        svgTools::normSW(attrs["stroke-width"]),
+        attrs.value("opacity", "1.0").toFloat()
+    };
+    pen.mFillRule = fillRule(attrs.value("fill-rule"));
+    return pen;
+}
+
+void graphic::bind(core::scene *scene, int node) {
+    element::bind(scene, node);
+    /// Elements are created around the node shape, otherwise the node shape replaces the shape of the constructor.
+    if(const auto &shape = (*scene)[node].shape) mShape = shape;
+    if(auto cache = scene->geometry(node)) mCache = cache;
+}
+
+void graphic::unbind() {
+    element::unbind();
+    if(mShape) mShape->setTransform(&mWorldTransform);
+    mOwnCache.setDecimate(mCache->decimate());
+    mOwnCache.invalidate();
+    mCache = &mOwnCache;
+}
+
+const shapes::geometry *graphic::geometry() const {
+    return mShape ? mCache->get(*mShape) : nullptr;
+}
+
+const shapes::geometry *graphic::geometry(const QTransform &rootTransform) const {
+    return mShape ? mCache->get(*mShape, worldTransform() * rootTransform) : nullptr;
+}
+
 element::Type graphic::type() const { return Type(mShape->type()); }
 
 bool graphic::contains(const QPointF &point) const {
-    return mShape->contains(point);
+    /// `PointState::Inside` is zero, so the state can't be converted to bool directly.
+    if(!mShape) return false;
+    worldTransform();
+    return mShape->contains(point) != PointState::None;
+}
+
+void graphic::updatePaintRect() {
+    if(!mShape) {
+        mPaintRect = QRectF();
+        return;
+    }
+    const qreal margin = mShape->pen().stroke() ? mShape->pen().mWidth / 2.0 : 0.0;
+    const QRectF &bb = mShape->boundingBox();
+    mPaintRect = worldTransform().mapRect(bb.adjusted(-margin, -margin, margin, margin));
+}
+
+void graphic::onUpdated() {
+    invalidateGeometry();
+
+    const QRectF before = mPaintRect;
+    updatePaintRect();
+    /// A null `before` rect means the old area is unknown (e.g. the element has not been painted yet).
+    emit damaged(before.isNull() ? QRectF() : before.united(mPaintRect));
 }
 
 QColor graphic::fill() const { return mShape->pen().mFill; }
@@ -41,30 +101,27 @@ QColor graphic::stroke() const { return mShape->pen().mStroke; }
 float graphic::strokeWidth() const { return mShape->pen().mWidth; }
 
 void graphic::setFill(const QColor &color) {
-    QRgb &fill = mShape->pen().mFill;
-    if(fill == color.rgba()) return;
-    fill = color.rgba();
+    if(mShape->pen().mFill == color.rgba()) return;
+    mShape->editPen([&](core::nanoPen &pen) { pen.mFill = color.rgba(); });
 
-    emit fillChanged();
-    emit updated();
+    notify(&graphic::fillChanged);
+    notify(&element::updated);
 }
 
 void graphic::setStroke(const QColor &color) {
-    QRgb &stroke = mShape->pen().mStroke;
-    if(stroke == color.rgba()) return;
-    stroke = color.rgba();
+    if(mShape->pen().mStroke == color.rgba()) return;
+    mShape->editPen([&](core::nanoPen &pen) { pen.mStroke = color.rgba(); });
 
-    emit strokeChanged();
-    emit updated();
+    notify(&graphic::strokeChanged);
+    notify(&element::updated);
 }
 
 void graphic::setStrokeWidth(float width) {
-    float &w = mShape->pen().mWidth;
-    if(qFuzzyCompare(w , width)) return;
-    w = width;
+    if(qFuzzyCompare(mShape->pen().mWidth, width)) return;
+    mShape->editPen([&](core::nanoPen &pen) { pen.mWidth = width; });
 
-    emit strokeWidthChanged();
-    emit updated();
+    notify(&graphic::strokeWidthChanged);
+    notify(&element::updated);
 }
 
 void graphic::setAttributes(const QVariantMap &attrs) {
@@ -74,7 +131,25 @@ void graphic::setAttributes(const QVariantMap &attrs) {
     if(attrs.contains("stroke-width")) {
         setStrokeWidth(svgTools::normSW(attrs["stroke-width"].toString()));
     }
+    if(attrs.contains("decimate")) setDecimate(attrs["decimate"].toBool());
+    if(attrs.contains("fill-rule")) {
+        const Qt::FillRule rule = fillRule(attrs["fill-rule"].toString());
+        mShape->editPen([&](core::nanoPen &pen) { pen.mFillRule = rule; });
+        notify(&element::updated);
+    }
 
     element::setAttributes(tools::filter(attrs, mainAttrs()));
 }
+
+void graphic::setDecimate(bool decimate) {
+    if(mCache->decimate() == decimate) return;
+    mCache->setDecimate(decimate);
+
+    notify(&graphic::decimateChanged);
+    notify(&element::updated);
+}
+
+Qt::FillRule graphic::fillRule(const QString &value) {
+    return value == "evenodd" ? Qt::OddEvenFill : Qt::WindingFill;
+}
 } // namespace veqtor::elements
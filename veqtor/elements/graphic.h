@@ -18,10 +18,11 @@ class graphic: public element {
     Q_PROPERTY(QColor fill READ fill WRITE setFill NOTIFY fillChanged)
     Q_PROPERTY(QColor stroke READ stroke WRITE setStroke NOTIFY strokeChanged)
     Q_PROPERTY(float strokeWidth READ strokeWidth WRITE setStrokeWidth NOTIFY strokeWidthChanged)
+    Q_PROPERTY(bool decimate READ decimate WRITE setDecimate NOTIFY decimateChanged)
 public:
     using shape_sptr = std::shared_ptr<shapes::shape>;
 
-    graphic(const shape_sptr& sh, QObject* parent, const QMap<QString, QString>& attrs);
+    graphic(const shape_sptr& sh, QObject* parent, const utils::attributeList& attrs);
     graphic(const shape_sptr& sh, QObject* parent = nullptr);
     graphic(QObject* parent = nullptr);
 
@@ -37,33 +38,85 @@ public:
     shape_sptr &shape();
 
     core::nanoPen pen() const override;
+    /** @brief parsePen, The pen of the `fill`, `stroke`, `stroke-width`, `fill-rule` and `opacity` attributes. */
+    static core::nanoPen parsePen(const utils::attributeList &attrs);
+
+    /**
+     * @brief geometry
+     * @abstract Retained paint commands of the shape. It's rebuilt lazily after the element is updated.
+     * @return geometry of path, series and line shapes, otherwise nullptr.
+     * @see shapes::geometryCache
+     */
+    const shapes::geometry *geometry() const;
+
+    /**
+     * @brief geometry
+     * @abstract The decimated geometry of the shape if `decimate` is enabled, otherwise the same as `geometry()`.
+     * @param rootTransform, Transform from the root coordinates to the device.
+     */
+    const shapes::geometry *geometry(const QTransform &rootTransform) const;
+    /** @brief geometryCache, The retained geometry, it's the cache of the scene node if the element is bound. */
+    const shapes::geometryCache &geometryCache() const { return *mCache; }
+
+    /**
+     * @brief paintRect
+     * @abstract The area covered by the shape (including half of the stroke width) in the root coordinates,
+     *  as of the last update. It's used for damage tracking and culling.
+     */
+    const QRectF &paintRect() const { return mPaintRect; }
+    void updatePaintRect();
 
     virtual Type type() const override;
     virtual bool contains(const QPointF& point) const override;
     void setOpacity(qreal _opacity) override {
-        mShape->pen().mOpacity = _opacity;
+        mShape->editPen([&](core::nanoPen &pen) { pen.mOpacity = _opacity; });
         element::setOpacity(_opacity);
     }
+    void bind(core::scene *scene, int node) override;
+    void unbind() override;
 
     QColor fill() const;
     QColor stroke() const;
     float strokeWidth() const;
+    bool decimate() const { return mCache->decimate(); }
 
     void setFill(const QColor& color);
     void setStroke(const QColor& color);
     void setStrokeWidth(float width);
+    void setDecimate(bool decimate);
 
     virtual void setAttributes(const QVariantMap &attrs) override;
 
+public slots:
+    void invalidateGeometry() { mCache->invalidate(); }
+
+private slots:
+    /// Invalidates the retained geometry and reports the old and new paint areas as damaged.
+    void onUpdated();
+
 private:
-    static QStringList mainAttrs() { return {"fill", "stroke", "stroke-width"}; }
+    static QStringList mainAttrs() { return {"fill", "stroke", "stroke-width", "fill-rule", "decimate"}; }
+    static Qt::FillRule fillRule(const QString &value);
 
 signals:
     void fillChanged();
     void strokeChanged();
     void strokeWidthChanged();
+    void decimateChanged();
+    /**
+     * @brief damaged
+     * @param rect, The united paint area before and after the change, in the root coordinates.
+     *  A null rect means the damaged area is unknown.
+     */
+    void damaged(const QRectF &rect);
 
 protected:
     shape_sptr mShape;
+
+private:
+    /// The own cache of the element, and the cache in use (the scene node cache of a bound element).
+    shapes::geometryCache mOwnCache;
+    shapes::geometryCache *mCache = &mOwnCache;
+    QRectF mPaintRect;
 };
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QObject>
+
+#include "../shapes/shapes.h"
+#include "container.h"
+
+namespace veqtor::elements {
+/**
+ * @brief The group class
+ * @abstract The `<g>` element, its transform and opacity apply to all of its children.
+ */
+class group final: public container {
+    Q_OBJECT
+public:
+    explicit group(const utils::attributeList &attrs = {}, QObject *parent = nullptr)
+        : container{parent, attrs} {}
+
+    Type type() const override { return Type::Group; }
+};
+}
@@ -14,17 +14,19 @@ class svg: public container {
     Q_OBJECT
     Q_PROPERTY(QRectF viewBox READ viewBox WRITE setViewBox NOTIFY viewBoxChanged)
 public:
-    explicit svg(QMap<QString, QString> attrs = {}, QObject *parent = nullptr)
-        : container{parent, utils::tools::filter(attrs, {"viewBox"})},
-          mViewBox(utils::svgTools::parseViewBox(attrs["viewBox"])) {}
+    explicit svg(const utils::attributeList &attrs = {}, QObject *parent = nullptr)
+        : container{parent, attrs}, mViewBox(utils::svgTools::parseViewBox(attrs["viewBox"])) {
+        dropAttributes({"viewBox"});
+    }
 
     Type type() const override { return Type::SVG; }
     const QRectF &viewBox() const { return mViewBox; }
     void setViewBox(const QRectF &viewBox) {
         if(viewBox == mViewBox) return;
         mViewBox = viewBox;
-        emit viewBoxChanged();
-        emit updated();
+        if(mScene) mScene->setViewBox(viewBox);
+        notify(&svg::viewBoxChanged);
+        notify(&element::updated);
     }
 
 signals:
@@ -3,8 +3,13 @@
 namespace veqtor::core {
 nanoPainter::nanoPainter() {}
 
+void nanoPainter::synchronize(QNanoQuickItem *item) {
+    Q_UNUSED(item)
+    mCanvas->snapshot(mFrame);
+}
+
 void nanoPainter::paint(QNanoPainter *p) {
-    mCanvas->painter(p);
+    mCanvas->painter(p, mFrame);
 }
 
 void nanoPainter::setCanvas(const canvas::veqtor *canvas) {
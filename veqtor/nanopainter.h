@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "qnanoquickitempainter.h"
 #include "qnanopainter.h"
 
@@ -8,13 +10,21 @@
 namespace veqtor::core {
 class veqtor;
 
+/**
+ * @brief The nanoPainter class
+ * @abstract Paints the item on the render thread. The document is only read in `synchronize` (the GUI thread is
+ *  blocked there), `paint` draws the snapshot of the display list that it takes.
+ */
 class nanoPainter : public QNanoQuickItemPainter {
 public:
     nanoPainter();
+    void synchronize(QNanoQuickItem *item) override;
     void paint(QNanoPainter *p) override;
     void setCanvas(const canvas::veqtor* canvas);
 
 private:
     const canvas::veqtor* mCanvas;
+    /// The visible items of the last synchronization, with their geometry.
+    std::vector<canvas::displayList::item> mFrame;
 };
 }
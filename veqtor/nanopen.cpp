@@ -0,0 +1,42 @@
+#include "nanopen.h"
+
+namespace veqtor::core {
+penTable &penTable::instance() {
+    static penTable table;
+    return table;
+}
+
+penTable::handle penTable::intern(const nanoPen &pen) {
+    penTable &table = instance();
+    const size_t hash = pen.hash();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+
+    auto range = table.mEntries.equal_range(hash);
+    for(auto i = range.first; i != range.second; ++i) {
+        handle entry = i->second.lock();
+        if(entry && *entry == pen) return entry;
+    }
+
+    if(table.mEntries.size() >= table.mPruneAt) {
+        for(auto i = table.mEntries.begin(); i != table.mEntries.end();) {
+            i = i->second.expired() ? table.mEntries.erase(i) : std::next(i);
+        }
+        table.mPruneAt = std::max<size_t>(64, 2 * table.mEntries.size());
+    }
+
+    handle entry = std::make_shared<const nanoPen>(pen);
+    table.mEntries.emplace(hash, entry);
+    return entry;
+}
+
+const penTable::handle &penTable::defaultPen() {
+    static const handle pen = intern(nanoPen());
+    return pen;
+}
+
+size_t penTable::size() {
+    penTable &table = instance();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    return table.mEntries.size();
+}
+}
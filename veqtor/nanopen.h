@@ -1,103 +1,195 @@
-#pragma once
-
-#include <QGradient>
-#include <QPen>
-
-#include <memory>
-
-#include "qnanopainter.h"
-
-namespace veqtor::core {
-/**
- * @brief The nanoPen struct
- */
-struct nanoPen {
-    nanoPen(QRgb fill = 0x0, QRgb stroke = 0x0, float width = 1.0, float opacity = 1.0,
-            QNanoPainter::LineCap cap = QNanoPainter::CAP_ROUND,
-            QNanoPainter::LineJoin join = QNanoPainter::JOIN_ROUND)
-        : mWinding(QNanoPainter::WINDING_CW), mCap(cap), mJoin(join),
-          mWidth(width), mOpacity(opacity), mFill(fill), mStroke(stroke) {}
-    nanoPen(QColor fill, QColor stroke, float width)
-        : nanoPen(fill.rgba(), stroke.rgba(), width) {}
-
-    void  setToPainter(QNanoPainter *painter) const {
-        /**
-         * TODO: add pattern as style.
-         */
-        painter->setFillStyle(mFill);
-        painter->setStrokeStyle(mStroke);
-        painter->setGlobalAlpha(mOpacity);
-        painter->setMiterLimit(mMiter);
-        painter->setLineWidth(mWidth);
-        painter->setLineCap(mCap);
-        painter->setLineJoin(mJoin);
-        painter->setPathWinding(mWinding);
-    }
-    void setJoin(const Qt::PenJoinStyle &join) { mJoin = fromQtJoin(join); }
-    void setJoin(const QNanoPainter::LineJoin &joinStyle) { mJoin = joinStyle; }
-    void setCap(const Qt::PenCapStyle &capStyle) { mCap = fromQtCap(capStyle); }
-    void setCap(const QNanoPainter::LineCap &capStyle) { mCap = capStyle; }
-
-    bool filled() const { return mFill; }
-    bool stroke() const { return mStroke; }
-    bool visible() const { return mFill || mStroke; }
-
-    operator Qt::PenCapStyle() const { return nanoPen::toQtCap(mCap); }
-    operator Qt::PenJoinStyle() const { return nanoPen::toQtJoin(mJoin); }
-
-    static QNanoPainter::LineCap fromQtCap(Qt::PenCapStyle capStyle) {
-        using LineCap = QNanoPainter::LineCap;
-        switch(capStyle) {
-            case Qt::FlatCap:   return LineCap::CAP_BUTT;
-            case Qt::SquareCap: return LineCap::CAP_SQUARE;
-            case Qt::RoundCap:  return LineCap::CAP_ROUND;
-            default: return LineCap::CAP_BUTT;
-        }
-    }
-
-    static Qt::PenCapStyle toQtCap(QNanoPainter::LineCap capStyle) {
-        using LineCap = QNanoPainter::LineCap;
-        switch(capStyle) {
-            case LineCap::CAP_BUTT: return Qt::FlatCap;
-            case LineCap::CAP_ROUND: return Qt::RoundCap;
-            case LineCap::CAP_SQUARE: return Qt::SquareCap;
-        }
-    }
-
-    static QNanoPainter::LineJoin fromQtJoin(Qt::PenJoinStyle joinStyle) {
-        using LineJoin = QNanoPainter::LineJoin;
-        switch(joinStyle) {
-            case Qt::RoundJoin: return LineJoin::JOIN_ROUND;
-            case Qt::BevelJoin: return LineJoin::JOIN_BEVEL;
-            case Qt::MiterJoin: return LineJoin::JOIN_MITER;
-            default: return LineJoin::JOIN_BEVEL;
-        }
-    }
-
-    static Qt::PenJoinStyle toQtJoin(QNanoPainter::LineJoin joinStyle) {
-        using LineJoin = QNanoPainter::LineJoin;
-        switch(joinStyle) {
-            case LineJoin::JOIN_ROUND: return Qt::RoundJoin;
-            case LineJoin::JOIN_BEVEL: return Qt::BevelJoin;
-            case LineJoin::JOIN_MITER: return Qt::MiterJoin;
-        }
-    }
-
-    QNanoPainter::PathWinding mWinding : 2;
-    QNanoPainter::LineCap mCap : 2;
-    QNanoPainter::LineJoin mJoin : 3;
-    QNanoPainter::TextAlign mTextAlign : 3;
-    QNanoPainter::TextBaseline mTextBaseLine : 7;
-    QNanoPainter::PixelAlign mPixelAlign : 2;
-    QNanoPainter::CompositeOperation mComposite : 4;
-    QNanoPainter::BlendFactor mBlend : 11;
-
-    float mWidth = 1.0f;
-    float mMiter = 10.0f;
-    float mOpacity = 1.0f;
-    QRgb mFill = 0x00000000; /// #AARRGGBB (Qt::transparent)
-    QRgb mStroke = 0x00000000; /// #AARRGGBB (Qt::transparent)
-
-    std::shared_ptr<QGradient> mGradient;
-};
-}
+#pragma once
+
+#include <QGradient>
+#include <QPen>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "qnanopainter.h"
+
+namespace veqtor::core {
+/**
+ * @brief The nanoPen struct
+ */
+struct nanoPen {
+    nanoPen(QRgb fill = 0x0, QRgb stroke = 0x0, float width = 1.0, float opacity = 1.0,
+            QNanoPainter::LineCap cap = QNanoPainter::CAP_ROUND,
+            QNanoPainter::LineJoin join = QNanoPainter::JOIN_ROUND)
+        : mWinding(QNanoPainter::WINDING_CW), mCap(cap), mJoin(join),
+          mWidth(width), mOpacity(opacity), mFill(fill), mStroke(stroke) {}
+    nanoPen(QColor fill, QColor stroke, float width)
+        : nanoPen(fill.rgba(), stroke.rgba(), width) {}
+
+    /** @brief setToPainter, Sets the style to a `QNanoPainter` or to a `canvas::rasterPainter`. */
+    template<class Painter>
+    void  setToPainter(Painter *painter) const {
+        /**
+         * TODO: add pattern as style.
+         */
+        painter->setFillStyle(mFill);
+        painter->setStrokeStyle(mStroke);
+        painter->setGlobalAlpha(mOpacity);
+        painter->setMiterLimit(mMiter);
+        painter->setLineWidth(mWidth);
+        painter->setLineCap(mCap);
+        painter->setLineJoin(mJoin);
+        painter->setPathWinding(mWinding);
+    }
+
+    /**
+     * @brief setToPainter
+     * @abstract Sends only the fields that differ from @a last, the style that is already set to the painter.
+     */
+    template<class Painter>
+    void setToPainter(Painter *painter, const nanoPen &last) const {
+        if(mFill != last.mFill) painter->setFillStyle(mFill);
+        if(mStroke != last.mStroke) painter->setStrokeStyle(mStroke);
+        if(mOpacity != last.mOpacity) painter->setGlobalAlpha(mOpacity);
+        if(mMiter != last.mMiter) painter->setMiterLimit(mMiter);
+        if(mWidth != last.mWidth) painter->setLineWidth(mWidth);
+        if(mCap != last.mCap) painter->setLineCap(mCap);
+        if(mJoin != last.mJoin) painter->setLineJoin(mJoin);
+        if(mWinding != last.mWinding) painter->setPathWinding(mWinding);
+    }
+
+    /// The text and blend fields are not set by veqtor yet (they are left uninitialized), so they are not compared.
+    bool operator == (const nanoPen &other) const {
+        return mFill == other.mFill && mStroke == other.mStroke && mWidth == other.mWidth &&
+               mOpacity == other.mOpacity && mMiter == other.mMiter && mCap == other.mCap &&
+               mJoin == other.mJoin && mWinding == other.mWinding && mFillRule == other.mFillRule &&
+               mGradient == other.mGradient;
+    }
+    bool operator != (const nanoPen &other) const { return !(*this == other); }
+
+    size_t hash() const {
+        size_t h = std::hash<QRgb>()(mFill);
+        const auto combine = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+        combine(mStroke);
+        combine(std::hash<float>()(mWidth));
+        combine(std::hash<float>()(mOpacity));
+        combine(std::hash<float>()(mMiter));
+        combine(size_t(mCap) | size_t(mJoin) << 4 | size_t(mWinding) << 8 | size_t(mFillRule) << 12);
+        combine(std::hash<QGradient *>()(mGradient.get()));
+        return h;
+    }
+
+    void setJoin(const Qt::PenJoinStyle &join) { mJoin = fromQtJoin(join); }
+    void setJoin(const QNanoPainter::LineJoin &joinStyle) { mJoin = joinStyle; }
+    void setCap(const Qt::PenCapStyle &capStyle) { mCap = fromQtCap(capStyle); }
+    void setCap(const QNanoPainter::LineCap &capStyle) { mCap = capStyle; }
+
+    bool filled() const { return mFill; }
+    bool stroke() const { return mStroke; }
+    bool visible() const { return mFill || mStroke; }
+
+    operator Qt::PenCapStyle() const { return nanoPen::toQtCap(mCap); }
+    operator Qt::PenJoinStyle() const { return nanoPen::toQtJoin(mJoin); }
+
+    static QNanoPainter::LineCap fromQtCap(Qt::PenCapStyle capStyle) {
+        using LineCap = QNanoPainter::LineCap;
+        switch(capStyle) {
+            case Qt::FlatCap:   return LineCap::CAP_BUTT;
+            case Qt::SquareCap: return LineCap::CAP_SQUARE;
+            case Qt::RoundCap:  return LineCap::CAP_ROUND;
+            default: return LineCap::CAP_BUTT;
+        }
+    }
+
+    static Qt::PenCapStyle toQtCap(QNanoPainter::LineCap capStyle) {
+        using LineCap = QNanoPainter::LineCap;
+        switch(capStyle) {
+            case LineCap::CAP_BUTT: return Qt::FlatCap;
+            case LineCap::CAP_ROUND: return Qt::RoundCap;
+            case LineCap::CAP_SQUARE: return Qt::SquareCap;
+        }
+    }
+
+    static QNanoPainter::LineJoin fromQtJoin(Qt::PenJoinStyle joinStyle) {
+        using LineJoin = QNanoPainter::LineJoin;
+        switch(joinStyle) {
+            case Qt::RoundJoin: return LineJoin::JOIN_ROUND;
+            case Qt::BevelJoin: return LineJoin::JOIN_BEVEL;
+            case Qt::MiterJoin: return LineJoin::JOIN_MITER;
+            default: return LineJoin::JOIN_BEVEL;
+        }
+    }
+
+    static Qt::PenJoinStyle toQtJoin(QNanoPainter::LineJoin joinStyle) {
+        using LineJoin = QNanoPainter::LineJoin;
+        switch(joinStyle) {
+            case LineJoin::JOIN_ROUND: return Qt::RoundJoin;
+            case LineJoin::JOIN_BEVEL: return Qt::BevelJoin;
+            case LineJoin::JOIN_MITER: return Qt::MiterJoin;
+        }
+    }
+
+    QNanoPainter::PathWinding mWinding : 2;
+    QNanoPainter::LineCap mCap : 2;
+    QNanoPainter::LineJoin mJoin : 3;
+    QNanoPainter::TextAlign mTextAlign : 3;
+    QNanoPainter::TextBaseline mTextBaseLine : 7;
+    QNanoPainter::PixelAlign mPixelAlign : 2;
+    QNanoPainter::CompositeOperation mComposite : 4;
+    QNanoPainter::BlendFactor mBlend : 11;
+
+    /// SVG `fill-rule`, it is used for hit testing (NanoVG fills by path winding).
+    Qt::FillRule mFillRule = Qt::WindingFill;
+
+    float mWidth = 1.0f;
+    float mMiter = 10.0f;
+    float mOpacity = 1.0f;
+    QRgb mFill = 0x00000000; /// #AARRGGBB (Qt::transparent)
+    QRgb mStroke = 0x00000000; /// #AARRGGBB (Qt::transparent)
+
+    std::shared_ptr<QGradient> mGradient;
+};
+
+/**
+ * @brief The penTable class
+ * @abstract A flyweight table of pens. Equal pens are interned to one shared entry, so shapes with the same style
+ *  share their pen, and the painter can skip a style by comparing pointers.
+ *  Entries are released when their last handle is destroyed. The table is thread-safe, since documents are
+ *  built and rendered on worker threads too.
+ */
+class penTable {
+public:
+    using handle = std::shared_ptr<const nanoPen>;
+
+    /** @return The entry that is equal to @a pen, it's created if there is none. */
+    static handle intern(const nanoPen &pen);
+    /** @return The entry of the default pen. */
+    static const handle &defaultPen();
+    /** @return Number of entries, including the released ones that are not pruned yet. */
+    static size_t size();
+
+private:
+    static penTable &instance();
+
+    std::mutex mMutex;
+    std::unordered_multimap<size_t, std::weak_ptr<const nanoPen>> mEntries;
+    /// Released entries are pruned when the table grows to this size.
+    size_t mPruneAt = 64;
+};
+
+/**
+ * @brief The penState class
+ * @abstract The style that was last sent to a painter. Applying a pen sends only the fields that changed,
+ *  and nothing if it's the same entry of the `penTable`. A state is valid for one painter in one frame.
+ */
+class penState {
+public:
+    template<class Painter>
+    void apply(Painter *painter, const penTable::handle &pen) {
+        if(pen == mLast) return;
+        mLast ? pen->setToPainter(painter, *mLast) : pen->setToPainter(painter);
+        mLast = pen;
+    }
+    /** @brief reset, Forgets the state, the next pen is sent entirely. */
+    void reset() { mLast.reset(); }
+
+private:
+    penTable::handle mLast;
+};
+}
@@ -1,130 +1,117 @@
 #include "painthelper.h"
-#include "utils/svgtools.h"
 
 namespace veqtor::canvas {
 paintHelper::paintHelper() {}
 
-void paintHelper::drawShape(QNanoPainter *painter,
-                            const std::shared_ptr<shapes::shape> &shape,
-                            const core::nanoPen &pen, const QTransform &rootTransform) {
-    if(shape && !shape->isNull() && pen.visible()) {
-        if(shape->type()) {
-            pen.setToPainter(painter);
-            painter->resetTransform();
-            painter->transform(shape->transformer() * rootTransform);
-            painter->beginPath();
-        }
+template<class Painter>
+void paintHelper::drawItem(Painter *painter, const displayList::item &item, core::penState &state) {
+    beginItem(painter, item, state);
+    appendItem(painter, item);
+    endItem(painter, item);
+}
 
-        switch(shape->type()) {
-        case shapes::Path:
-            drawPath(painter, std::dynamic_pointer_cast<shapes::path>(shape));
-            break;
-        case shapes::Line:
-            drawLine(painter, std::dynamic_pointer_cast<shapes::line>(shape));
-            break;
-        case shapes::Ellipse:
-            drawEllipse(painter, std::dynamic_pointer_cast<shapes::ellipse>(shape));
-            break;
-        case shapes::Rect:
-            drawRect(painter, std::dynamic_pointer_cast<shapes::rect>(shape));
-            break;
-        case shapes::Polygon:
-        case shapes::Shape:
-        default:
-            break;
-        }
+template<class Painter>
+paintHelper::drawStats paintHelper::drawList(Painter *painter, const std::vector<displayList::item> &items) {
+    drawStats stats;
+    core::penState state;
+    /// The first item of the path that is being built, and the paint area of the path.
+    const displayList::item *run = nullptr;
+    QRectF runRect;
 
-        if(shape->type()) {
-            pen.mFill ? painter->fill() : void();
-            pen.mStroke ? painter->stroke() : void();
+    for(const displayList::item &item: items) {
+        if(run && canMerge(*run, runRect, item)) {
+            appendItem(painter, item);
+            runRect = runRect.united(item.paintRect);
+            stats.merged += bool(item.pen->mFill) + bool(item.pen->mStroke);
+            continue;
         }
+
+        if(run) stats.drawCalls += endItem(painter, *run);
+        beginItem(painter, item, state);
+        appendItem(painter, item);
+        run = &item;
+        runRect = item.paintRect;
     }
+    if(run) stats.drawCalls += endItem(painter, *run);
+    return stats;
 }
 
-void paintHelper::drawPath(QNanoPainter *painter, const std::shared_ptr<shapes::path> &path) {
-    using path_data = shapes::pathdata;
-    /// @brief "current from", "last to" and "last cubic control" points
-    apoint from{}, lto{}, alcc{};
+bool paintHelper::canMerge(const displayList::item &run, const QRectF &runRect, const displayList::item &item) {
+    /// Pens are interned, so equal styles have the same entry.
+    if(item.pen != run.pen || item.device != run.device) return false;
 
-    /// Add a moveTo at the beginning of the path if it doesn't start with one.
-    if(!path->empty() && !path->front().isMove()) {
-        painter->moveTo(path->front().to);
+    /// Overlaps are painted once in a merged path, that only looks the same if the colors are opaque.
+    const core::nanoPen &pen = *item.pen;
+    if(pen.mOpacity < 1.0f || (pen.mFill && qAlpha(pen.mFill) != 255) ||
+       (pen.mStroke && qAlpha(pen.mStroke) != 255)) {
+        return false;
     }
 
-    for(const path_data &p: *path) {
-        /// @brief Convert "p.to" point to "absolute to"
-        apoint add = p.relative ? from : apoint{};
-        apoint ato = p.to + add;
-
-        switch(p.type()) {
-            case path_data::Close: painter->closePath(); break;
-            case path_data::Move: painter->moveTo(ato); lto = ato; break;
-            case path_data::Line: painter->lineTo(ato); break;
-            case path_data::Hr: ato.setY(from.y()); painter->lineTo(ato); break;
-            case path_data::Vr: ato.setX(from.x()); painter->lineTo(ato); break;
-            case path_data::Quad: {
-                apoint c = p.quad().control;
-                painter->quadTo(c + add, ato);
-                break;
-            }
-            case shapes::pathdata::ShortQuad: {
-                break;
-            }
-            case path_data::Cubic: {
-                apoint c1 = p.cubic().c1, c2 = p.cubic().c2;
-                painter->bezierTo(c1 + add, c2 + add, ato);
-                alcc = c2 + add;
-                break;
-            }
-            case path_data::Arc: {
-                auto cubics = utils::svgTools::arcToCubic(p.arc(), from, ato);
-                for(const auto &cubic: cubics) {
-                    auto _cubic = cubic.cubic();
-                    painter->bezierTo(_cubic.c1, _cubic.c2, cubic.to);
-                }
-                break;
-            }
-            case path_data::ShortCubic: {
-                /// Reflection of last point to "from" point.
-                apoint ac1 = alcc.isNull() ? from : 2 * from - alcc,
-                       c2 = p.scubic().control;
-                painter->bezierTo(ac1, c2 + add, ato);
-                alcc = c2 + add;
-                break;
-            }
-        }
-        from = (!p.isClose() ? ato : lto);
-        alcc = p.isCubic() || p.isShortCubic() ? alcc : apoint{0,0};
+    /// The path is filled before it's stroked, so a filled item would be painted under the stroke of the previous
+    /// items. Overlapping subpaths could also cancel out if their directions differ (QPainter doesn't enforce the
+    /// winding like NanoVG). So filled items are only merged if they don't overlap the path.
+    if(pen.mFill) {
+        return !item.paintRect.isNull() && !runRect.isNull() && !runRect.intersects(item.paintRect);
     }
+    return true;
 }
 
-void paintHelper::drawRect(QNanoPainter *painter, const std::shared_ptr<shapes::rect> &rect) {
-    drawRect(painter, *rect);
-}
-
-void paintHelper::drawRect(QNanoPainter *painter, const QRectF &rect) {
+template<class Painter>
+void paintHelper::beginItem(Painter *painter, const displayList::item &item, core::penState &state) {
+    state.apply(painter, item.pen);
+    painter->resetTransform();
+    painter->transform(item.device);
     painter->beginPath();
-    painter->rect(rect);
 }
 
-void paintHelper::drawEllipse(QNanoPainter *painter, const std::shared_ptr<shapes::ellipse> &ellipse) {
-    painter->ellipse(*ellipse);
+template<class Painter>
+size_t paintHelper::endItem(Painter *painter, const displayList::item &item) {
+    item.pen->mFill ? painter->fill() : void();
+    item.pen->mStroke ? painter->stroke() : void();
+    return bool(item.pen->mFill) + bool(item.pen->mStroke);
 }
 
-void paintHelper::drawLine(QNanoPainter *painter, const std::shared_ptr<shapes::line> &line) {
-    drawLine(painter, *line);
+template<class Painter>
+void paintHelper::appendItem(Painter *painter, const displayList::item &item) {
+    /// Paths, series and lines are retained geometry, rects and ellipses are single primitives.
+    switch(item.type) {
+    case shapes::Ellipse:
+        painter->ellipse(item.box);
+        break;
+    case shapes::Rect:
+        drawRect(painter, item.box, item.radius);
+        break;
+    default:
+        if(item.frame) drawGeometry(painter, *item.frame);
+        break;
+    }
 }
 
-void paintHelper::drawLine(QNanoPainter *painter, const QLineF &line) {
-    painter->moveTo(line.p1());
-    painter->lineTo(line.p2());
+template<class Painter>
+void paintHelper::drawGeometry(Painter *painter, const shapes::geometry &geometry) {
+    using geo = shapes::geometry;
+    const float *c = geometry.coords().data();
+
+    for(const geo::Verb verb: geometry.verbs()) {
+        switch(verb) {
+            case geo::Move: painter->moveTo(c[0], c[1]); break;
+            case geo::Line: painter->lineTo(c[0], c[1]); break;
+            case geo::Quad: painter->quadTo(c[0], c[1], c[2], c[3]); break;
+            case geo::Cubic: painter->bezierTo(c[0], c[1], c[2], c[3], c[4], c[5]); break;
+            case geo::Close: painter->closePath(); break;
+        }
+        c += geo::coordCount(verb);
+    }
 }
 
-void paintHelper::drawPoint(QNanoPainter *painter, const QPointF &point) {
-    /// @brief draw two crossing lines for single point.
-    QLineF vLine(point - QPointF(2, 2), point + QPointF(2, 2));
-    QLineF hLine(point - QPointF(2,-2), point + QPointF(2,-2));
-    drawLine(painter, vLine);
-    drawLine(painter, hLine);
+template<class Painter>
+void paintHelper::drawRect(Painter *painter, const QRectF &rect, float radius) {
+    radius > 0 ? painter->roundedRect(rect, radius) : painter->rect(rect);
 }
+
+/// The item pipeline is shared by the item (NanoVG) and the offscreen renderer (QPainter).
+template void paintHelper::drawItem(QNanoPainter *, const displayList::item &, core::penState &);
+template void paintHelper::drawItem(rasterPainter *, const displayList::item &, core::penState &);
+template paintHelper::drawStats paintHelper::drawList(QNanoPainter *, const std::vector<displayList::item> &);
+template paintHelper::drawStats paintHelper::drawList(rasterPainter *, const std::vector<displayList::item> &);
 }
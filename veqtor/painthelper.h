@@ -7,84 +7,86 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 #include "nanopen.h"
 #include "shapes/shapes.h"
+#include "displaylist.h"
+#include "rasterpainter.h"
 
 namespace veqtor::canvas {
 class paintHelper {
 public:
+    /** @brief The drawStats struct, the fill and stroke submissions of a list. */
+    struct drawStats {
+        size_t drawCalls = 0;
+        /// Submissions that were saved by merging items into the path of a previous item.
+        size_t merged = 0;
+    };
+
     paintHelper();
 
     /**
-     * @param painter
-     * @param shape
-     * @param pen
-     * @brief drawShape
-     * Draw shapes based on their types.
+     * @param painter, A `QNanoPainter` or a `rasterPainter` (they are instantiated in painthelper.cpp).
+     * @param item
+     * @param state, The style that is set to the painter, only the changed fields of the item pen are sent.
+     * @brief drawItem
+     * Draw a snapshot item (see `displayList::snapshot`) with its resolved pen and cached device transform.
      */
-    static void drawShape(QNanoPainter *painter,
-                          const std::shared_ptr<shapes::shape> &shape,
-                          const core::nanoPen &pen,
-                          const QTransform &rootTransform = QTransform());
+    template<class Painter>
+    static void drawItem(Painter *painter, const displayList::item &item, core::penState &state);
 
     /**
-     * @param painter
-     * @param path
-     * @brief drawPath
-     * Draw path shape.
+     * @param painter, A `QNanoPainter` or a `rasterPainter`.
+     * @param items, A snapshot of the visible items, see `displayList::snapshot`.
+     * @brief drawList
+     * Draw the items in paint order. Consecutive items with the same pen and device transform are
+     * built into one path and filled and stroked once, if the result looks the same (see `canMerge`).
+     * @return The submitted and the saved draw calls.
      */
-    static void drawPath(QNanoPainter *painter, const std::shared_ptr<shapes::path> &path);
+    template<class Painter>
+    static drawStats drawList(Painter *painter, const std::vector<displayList::item> &items);
 
     /**
-     * @param painter
-     * @param rect
-     * @brief drawRect
-     * Draw a rectangle.
+     * @param run, The first item of the current path.
+     * @param runRect, The paint area of the items in the current path.
+     * @param item
+     * @brief canMerge
+     * Items are merged if they have the same pen entry and device transform, and their colors are opaque.
+     * Filled items must also not overlap the current path.
      */
-    static void drawRect(QNanoPainter *painter, const std::shared_ptr<shapes::rect> &rect);
+    static bool canMerge(const displayList::item &run, const QRectF &runRect, const displayList::item &item);
 
     /**
      * @param painter
-     * @param rect
-     * @brief drawRect
-     * Draw given QRectF.
+     * @param geometry
+     * @brief drawGeometry
+     * Replay retained geometry commands.
      */
-    static void drawRect(QNanoPainter *painter, const QRectF &rect);
+    template<class Painter>
+    static void drawGeometry(Painter *painter, const shapes::geometry &geometry);
 
     /**
      * @param painter
-     * @param ellipse
-     * @brief drawEllipse
-     * Draw given shapes::ellipse pointer.
-     */
-    static void drawEllipse(QNanoPainter *painter, const std::shared_ptr<shapes::ellipse> &ellipse);
-
-    /**
-     * @param painter
-     * @param line
-     * @brief drawLine
-     * Draw given shapes::line pointer.
-     */
-    static void drawLine(QNanoPainter *painter, const std::shared_ptr<shapes::line> &line);
-
-    /**
-     * @param painter
-     * @param line
-     * @brief drawLine
-     * Draw given shapes::line pointer.
+     * @param rect
+     * @param radius
+     * @brief drawRect
+     * Draw a rectangle, or a rounded rectangle if it has a corner radius, with a single primitive.
      */
-    static void drawLine(QNanoPainter *painter, const QLineF &line);
+    template<class Painter>
+    static void drawRect(Painter *painter, const QRectF &rect, float radius);
 
-    /**
-     * @param painter
-     * @param point
-     * @brief drawPoint
-     * Draw given QPointF.
-     * Two crossing lines for single point.
-     */
-    static void drawPoint(QNanoPainter *painter, const QPointF &point);
+private:
+    /// Sets the pen and the transform of an item, and begins a new path.
+    template<class Painter>
+    static void beginItem(Painter *painter, const displayList::item &item, core::penState &state);
+    /// Adds the shape of an item to the current path.
+    template<class Painter>
+    static void appendItem(Painter *painter, const displayList::item &item);
+    /// Fills and strokes the current path with the pen of an item, returns the number of the draw calls.
+    template<class Painter>
+    static size_t endItem(Painter *painter, const displayList::item &item);
 };
 }
@@ -10,55 +10,50 @@ import veqtor 0.1
 Control {
     id: control
 
-    property Range xaxis: Range { max: 10; onChanged: Qt.callLater(priv.reDraw) }
-    property Range yaxis: Range { max: 10; onChanged: Qt.callLater(priv.reDraw) }
+    property Range xaxis: Range { max: 10 }
+    property Range yaxis: Range { max: 10 }
     property real strokeWidth: 0.4
+    /// Maximum number of the plotted samples, the oldest ones are dropped.
+    property int capacity: 4096
 
     readonly property List list: List {
-        onClread: priv.plot.clear();
-        onDataShifted: priv.plot.shift();
-        onValueAppended: priv.reDraw();
-        onDataChanged: priv.reDraw();
+        onClread: priv.reload();
+        onDataShifted: {
+            priv.offset++;
+            priv.plot.shift();
+        }
+        onValueAppended: (length, value) => priv.plot.append(Qt.point(priv.offset + length - 1, value));
+        onDataChanged: priv.reload();
     }
 
-    onWidthChanged: Qt.callLater(priv.reDraw)
-    onHeightChanged: Qt.callLater(priv.reDraw)
-
     QtObject {
         id: priv
         property var plot: veq.document.plot
+        /// Number of the shifted samples, the x value of a sample is its index plus the offset.
+        property int offset: 0
 
-        function map(value: real, from, to): real {
-            return (value - from[0]) / (from[1] - from[0]) * (to[1] - to[0]) + to[0];
-        }
-
-        function valueToPoint(x: int, y: int): point {
-            return Qt.point(
-                map(x, [0, xaxis.dist - 1], [0, control.availableWidth]),
-                map(y, [yaxis.min, yaxis.max], [control.availableHeight, 0])
-            )
-        }
-
-        function reDraw() {
+        function reload() {
+            priv.offset = 0;
             priv.plot.clear();
-            const partialData = list.slice(xaxis.min, xaxis.max);
-            partialData.forEach((data, index) => {
-                const point = valueToPoint(index, data);
-                priv.plot.lineTo(point);
-            });
+            priv.plot.appendPoints(list.map((value, index) => Qt.point(index, value)));
         }
     }
 
     contentItem: Control {
         contentItem: Veqtor {
             id: veq
-            src: "<svg viewBox='0 0 100 100'><path id='plot' fill='none'/></svg>"
+            src: "<svg viewBox='0 0 100 100'><series id='plot' fill='none' decimate='true'/></svg>"
             onSvgLoaded: {
-                const path = document.plot;
+                const plot = document.plot;
                 root.viewBox.width = Qt.binding(() => control.availableWidth);
                 root.viewBox.height = Qt.binding(() => control.availableHeight);
-                path.strokeWidth = Qt.binding(() => control.strokeWidth);
-                path.stroke = Qt.binding(() => control.palette.highlight);
+                plot.capacity = Qt.binding(() => control.capacity);
+                plot.strokeWidth = Qt.binding(() => control.strokeWidth);
+                plot.stroke = Qt.binding(() => control.palette.highlight);
+                /// Samples are mapped at paint time, so moving the axes does not rebuild the plot.
+                plot.window = Qt.binding(() => Qt.rect(priv.offset + xaxis.min, yaxis.min,
+                                                       Math.max(xaxis.dist - 1, 1), yaxis.dist));
+                plot.viewport = Qt.binding(() => Qt.rect(0, 0, control.availableWidth, control.availableHeight));
             }
         }
     }
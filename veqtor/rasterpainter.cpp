@@ -0,0 +1,33 @@
+#include "rasterpainter.h"
+#include "nanopen.h"
+
+namespace veqtor::canvas {
+rasterPainter::rasterPainter(QPainter *painter)
+    : mPainter(painter), mBase(painter->worldTransform()) {
+    mPainter->setRenderHint(QPainter::Antialiasing);
+}
+
+void rasterPainter::setLineCap(QNanoPainter::LineCap cap) {
+    mPen.setCapStyle(core::nanoPen::toQtCap(cap));
+}
+
+void rasterPainter::setLineJoin(QNanoPainter::LineJoin join) {
+    mPen.setJoinStyle(core::nanoPen::toQtJoin(join));
+}
+
+void rasterPainter::fill() {
+    mPainter->fillPath(mPath, color(mFill));
+}
+
+void rasterPainter::stroke() {
+    QPen pen = mPen;
+    pen.setColor(color(mStroke));
+    mPainter->strokePath(mPath, pen);
+}
+
+QColor rasterPainter::color(QRgb rgba) const {
+    QColor c = QColor::fromRgba(rgba);
+    c.setAlphaF(c.alphaF() * mAlpha);
+    return c;
+}
+}
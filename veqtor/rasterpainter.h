@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QTransform>
+
+#include "qnanopainter.h"
+
+namespace veqtor::canvas {
+/**
+ * @brief The rasterPainter class
+ * @abstract A CPU backend for `paintHelper`: it has the subset of the `QNanoPainter` interface that the paint
+ *  helper and `nanoPen` use, and paints with a `QPainter`. So the same paint code renders into a `QImage`
+ *  (or a `QPdfWriter`) without an OpenGL context, on any thread.
+ *  Like NanoVG, points are mapped by the transform that is set when the path is built.
+ */
+class rasterPainter {
+public:
+    /**
+     * @param painter, The target painter, its transform at construction is the base of `resetTransform`.
+     */
+    explicit rasterPainter(QPainter *painter);
+
+    void setFillStyle(QRgb color) { mFill = color; }
+    void setStrokeStyle(QRgb color) { mStroke = color; }
+    void setGlobalAlpha(float alpha) { mAlpha = alpha; }
+    void setMiterLimit(float limit) { mPen.setMiterLimit(limit); }
+    void setLineWidth(float width) { mPen.setWidthF(width); }
+    void setLineCap(QNanoPainter::LineCap cap);
+    void setLineJoin(QNanoPainter::LineJoin join);
+    /// NanoVG uses the winding for holes, paths are filled with the nonzero rule here.
+    void setPathWinding(QNanoPainter::PathWinding) {}
+
+    void resetTransform() { mPainter->setWorldTransform(mBase); }
+    /** @brief transform, Applies @a transform before the current transform. */
+    void transform(const QTransform &transform) { mPainter->setWorldTransform(transform, true); }
+
+    void beginPath() {
+        mPath = QPainterPath();
+        mPath.setFillRule(Qt::WindingFill);
+    }
+    void moveTo(float x, float y) { mPath.moveTo(x, y); }
+    void moveTo(const QPointF &point) { mPath.moveTo(point); }
+    void lineTo(float x, float y) { mPath.lineTo(x, y); }
+    void lineTo(const QPointF &point) { mPath.lineTo(point); }
+    void quadTo(float cx, float cy, float x, float y) { mPath.quadTo(cx, cy, x, y); }
+    void bezierTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+        mPath.cubicTo(c1x, c1y, c2x, c2y, x, y);
+    }
+    void bezierTo(const QPointF &c1, const QPointF &c2, const QPointF &to) { mPath.cubicTo(c1, c2, to); }
+    void closePath() { mPath.closeSubpath(); }
+    void rect(const QRectF &rect) { mPath.addRect(rect); }
+    void roundedRect(const QRectF &rect, float radius) { mPath.addRoundedRect(rect, radius, radius); }
+    void ellipse(const QRectF &rect) { mPath.addEllipse(rect); }
+
+    void fill();
+    void stroke();
+
+private:
+    QColor color(QRgb rgba) const;
+
+    QPainter *mPainter;
+    QTransform mBase;
+    QPainterPath mPath;
+    QPen mPen;
+    QRgb mFill = 0x0;
+    QRgb mStroke = 0x0;
+    float mAlpha = 1.0f;
+};
+}
@@ -0,0 +1,114 @@
+#include <vector>
+#include <cstdint>
+
+#include "renderer.h"
+#include "displaylist.h"
+#include "painthelper.h"
+#include "rasterpainter.h"
+#include "elements/graphic.h"
+#include "utils/svgtools.h"
+
+namespace veqtor::canvas {
+bool renderer::render(elements::svg *root, const QSize &size, QImage &image) {
+    if(!root || size.isEmpty()) return false;
+
+    prepare(image, size);
+    QPainter painter(&image);
+    return render(root, &painter, QRectF(QPointF(), size));
+}
+
+QImage renderer::render(elements::svg *root, const QSize &size) {
+    QImage image;
+    return render(root, size, image) ? image : QImage();
+}
+
+bool renderer::render(elements::svg *root, QPainter *painter, const QRectF &target) {
+    if(!root || !painter || target.isEmpty()) return false;
+    if(root->scene()) return render(*root->scene(), painter, target);
+
+    std::vector<QPointer<elements::graphic>> graphics;
+    QRectF bounds;
+    root->walk([&](const QPointer<elements::element> &el) {
+        if(auto graphic = qobject_cast<elements::graphic*>(el.data())) {
+            graphic->updatePaintRect();
+            bounds = bounds.united(graphic->paintRect());
+            graphics.push_back(graphic);
+        }
+    });
+
+    /// A document without a view box is fitted by the area of its shapes.
+    const QRectF viewBox = root->viewBox().isValid() ? root->viewBox() : bounds;
+    if(!viewBox.isValid()) return true;
+
+    displayList list;
+    list.setRootTransform(fit(viewBox, target));
+    list.build(graphics);
+    draw(list, painter, target);
+    return true;
+}
+
+bool renderer::render(const core::scene &scene, const QSize &size, QImage &image) {
+    if(scene.empty() || size.isEmpty()) return false;
+
+    prepare(image, size);
+    QPainter painter(&image);
+    return render(scene, &painter, QRectF(QPointF(), size));
+}
+
+QImage renderer::render(const core::scene &scene, const QSize &size) {
+    QImage image;
+    return render(scene, size, image) ? image : QImage();
+}
+
+bool renderer::render(const core::scene &scene, QPainter *painter, const QRectF &target) {
+    if(scene.empty() || !painter || target.isEmpty()) return false;
+
+    QRectF viewBox = scene.viewBox();
+    if(!viewBox.isValid()) {
+        for(const int node: scene.graphics()) viewBox = viewBox.united(scene.paintRect(node));
+    }
+    if(!viewBox.isValid()) return true;
+
+    displayList list;
+    list.setRootTransform(fit(viewBox, target));
+    list.build(scene);
+    draw(list, painter, target);
+    return true;
+}
+
+QImage renderer::render(const QString &src, const QSize &size) {
+    const auto scene = utils::svgTools::sceneParser(utils::tools::contentResolver(src));
+    QImage image;
+    if(scene && !scene->empty() && (*scene)[0].type == elements::element::SVG) render(*scene, size, image);
+    return image;
+}
+
+void renderer::prepare(QImage &image, const QSize &size) {
+    if(image.size() != size || image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    }
+    image.fill(Qt::transparent);
+}
+
+void renderer::draw(const displayList &list, QPainter *painter, const QRectF &target) {
+    std::vector<displayList::item> frame;
+    std::vector<std::uint8_t> inside;
+    list.snapshot(target, frame, inside);
+
+    painter->save();
+    rasterPainter raster(painter);
+    paintHelper::drawList(&raster, frame);
+    painter->restore();
+}
+
+QTransform renderer::fit(const QRectF &viewBox, const QRectF &target) {
+    const qreal scale = std::min(target.width() / viewBox.width(), target.height() / viewBox.height());
+    QTransform t;
+    /// Move the SVG shape to center of the target, and scale it to fit.
+    t.translate(target.x() + (target.width() - scale * viewBox.width()) / 2,
+                target.y() + (target.height() - scale * viewBox.height()) / 2);
+    t.scale(scale, scale);
+    t.translate(-viewBox.x(), -viewBox.y());
+    return t;
+}
+}
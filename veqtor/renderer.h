@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+#include <QSize>
+#include <QTransform>
+
+#include "elements/svg.h"
+#include "scene.h"
+
+namespace veqtor::canvas {
+class displayList;
+
+/**
+ * @brief The renderer class
+ * @abstract Renders documents without a QML scene, e.g. thumbnails or report pages in a headless batch job.
+ *  It uses the display list and the paint helper of the `Veqtor` item with the `rasterPainter` (CPU) backend,
+ *  so it doesn't need an OpenGL context or a window.
+ *  Calls don't share any state, so documents can be rendered in parallel on any thread, but a scene or an element
+ *  tree (its cached geometry) must only be used by one thread at a time.
+ */
+class renderer {
+public:
+    /**
+     * @brief render
+     * @abstract Renders @a root into @a image, fitted and centered like the `Veqtor` item.
+     * @param image, It's (re)allocated as premultiplied ARGB32 if its size or format differs, and cleared.
+     * @return false if there is no root or the size is empty.
+     */
+    static bool render(elements::svg *root, const QSize &size, QImage &image);
+    static QImage render(elements::svg *root, const QSize &size);
+
+    /**
+     * @brief render
+     * @abstract Renders @a root into the @a target area of any painter (e.g. a `QPdfWriter` page).
+     *  The root of a loaded document is rendered from its scene.
+     * @return false if there is no root or the target is empty.
+     */
+    static bool render(elements::svg *root, QPainter *painter, const QRectF &target);
+
+    /**
+     * @brief render
+     * @abstract Renders a scene (see `svgTools::sceneParser`), without creating any element.
+     * @return false if the scene or the size is empty.
+     */
+    static bool render(const core::scene &scene, const QSize &size, QImage &image);
+    static QImage render(const core::scene &scene, const QSize &size);
+    static bool render(const core::scene &scene, QPainter *painter, const QRectF &target);
+
+    /**
+     * @brief render
+     * @abstract Reads and parses @a src (a file path, a url or an SVG document) into a scene on the calling thread,
+     *  and renders it.
+     * @return The image, or a null image if the source is not a valid document.
+     */
+    static QImage render(const QString &src, const QSize &size);
+
+    /** @return The transform that fits @a viewBox into @a target (keeping its aspect ratio) and centers it. */
+    static QTransform fit(const QRectF &viewBox, const QRectF &target);
+
+private:
+    /// (Re)allocates the image as premultiplied ARGB32 and clears it.
+    static void prepare(QImage &image, const QSize &size);
+    /// Culls the list by the target, and draws it with the painter.
+    static void draw(const displayList &list, QPainter *painter, const QRectF &target);
+};
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+
+#include "scene.h"
+#include "utils/svgtools.h"
+#include "utils/transformstack.h"
+
+namespace veqtor::core {
+scene::~scene() {
+    /// The elements may still be referenced by QML, so they are detached from the nodes now and deleted later.
+    for(const auto &el: qAsConst(mWrappers)) {
+        if(el) el->unbind();
+    }
+    if(const auto root = mWrappers.value(0)) root->deleteLater();
+}
+
+int scene::open(Type type, utils::attributeList &&attrs, std::shared_ptr<shapes::shape> &&shape) {
+    node n;
+    n.type = type;
+    n.parent = mOpen.empty() ? -1 : mOpen.back();
+    n.id = attrs.value("id");
+    n.transform = utils::transformStack::parse(attrs.value("transform")).matrix();
+    n.opacity = attrs.value("opacity", "1.0").toFloat();
+    n.shape = std::move(shape);
+    n.attributes = std::move(attrs);
+
+    mNodes.push_back(std::move(n));
+    mOpen.push_back(size() - 1);
+    return size() - 1;
+}
+
+void scene::close() {
+    if(mOpen.empty()) return;
+    mNodes[mOpen.back()].end = size();
+    mOpen.pop_back();
+}
+
+void scene::finalize() {
+    /// An unterminated document keeps the nodes that are parsed.
+    while(!mOpen.empty()) close();
+
+    mWorld.assign(mNodes.size(), QTransform());
+    mWorldOpacity.assign(mNodes.size(), 1.0);
+    mWorldValid.assign(mNodes.size(), false);
+
+    mGraphics.clear();
+    mIds.clear();
+    for(int i = 0; i < size(); ++i) {
+        node &n = mNodes[i];
+        /// The last node of a repeated id is found, like the last element in the document map.
+        if(!n.id.isEmpty()) mIds.insert(n.id, i);
+        if(!n.shape) continue;
+
+        n.graphic = static_cast<int>(mGraphics.size());
+        mGraphics.push_back(i);
+        /// Shapes are hit-tested and bounded in the root coordinates.
+        n.shape->setTransform(&mWorld[i]);
+    }
+
+    mGeometry.resize(mGraphics.size());
+    for(size_t id = 0; id < mGraphics.size(); ++id) {
+        mGeometry[id].setDecimate(mNodes[mGraphics[id]].attributes.value("decimate") == "true");
+    }
+
+    if(!empty() && mNodes.front().type == Type::SVG) {
+        mViewBox = utils::svgTools::parseViewBox(mNodes.front().attributes.value("viewBox"));
+    }
+}
+
+std::vector<int> scene::children(int node) const {
+    std::vector<int> list;
+    for(int i = node + 1; i < mNodes[node].end; i = mNodes[i].end) list.push_back(i);
+    return list;
+}
+
+std::pair<int, int> scene::graphicRange(int node) const {
+    /// Graphics are in pre-order too, so the graphics of a subtree are consecutive.
+    const auto first = std::lower_bound(mGraphics.cbegin(), mGraphics.cend(), node);
+    const auto last = std::lower_bound(first, mGraphics.cend(), mNodes[node].end);
+    return {static_cast<int>(first - mGraphics.cbegin()), static_cast<int>(last - mGraphics.cbegin())};
+}
+
+const QTransform &scene::world(int node) const {
+    if(!mWorldValid[node]) {
+        const struct node &n = mNodes[node];
+        if(n.parent >= 0) {
+            mWorld[node] = n.transform * world(n.parent);
+            mWorldOpacity[node] = n.opacity * mWorldOpacity[n.parent];
+        } else {
+            mWorld[node] = n.transform;
+            mWorldOpacity[node] = n.opacity;
+        }
+        mWorldValid[node] = true;
+    }
+    return mWorld[node];
+}
+
+qreal scene::worldOpacity(int node) const {
+    world(node);
+    return mWorldOpacity[node];
+}
+
+QRectF scene::paintRect(int node) const {
+    const auto &shape = mNodes[node].shape;
+    if(!shape) return QRectF();
+
+    const qreal margin = shape->pen().stroke() ? shape->pen().mWidth / 2.0 : 0.0;
+    const QRectF &bb = shape->boundingBox();
+    return world(node).mapRect(bb.adjusted(-margin, -margin, margin, margin));
+}
+
+bool scene::contains(int node, const QPointF &point) const {
+    const auto &shape = mNodes[node].shape;
+    if(!shape) return false;
+    /// The shape reads the cached world transform, so it's validated first.
+    world(node);
+    return shape->contains(point) != PointState::None;
+}
+
+shapes::geometryCache *scene::geometry(int node) const {
+    const int id = mNodes[node].graphic;
+    return id < 0 ? nullptr : &mGeometry[id];
+}
+
+void scene::setTransform(int node, const QTransform &transform) {
+    mNodes[node].transform = transform;
+    invalidateWorld(node);
+}
+
+void scene::setOpacity(int node, qreal opacity) {
+    mNodes[node].opacity = opacity;
+    invalidateWorld(node);
+}
+
+void scene::setId(int node, const QString &id) {
+    struct node &n = mNodes[node];
+    if(mIds.value(n.id, -1) == node) mIds.remove(n.id);
+    n.id = id;
+    if(!id.isEmpty()) mIds.insert(id, node);
+}
+
+void scene::invalidateWorld(int node) {
+    std::fill(mWorldValid.begin() + node, mWorldValid.begin() + mNodes[node].end, false);
+}
+
+QPointer<elements::element> scene::wrapper(int node) {
+    if(node < 0 || node >= size()) return nullptr;
+    if(const auto el = mWrappers.value(node)) return el;
+
+    /// The elements mirror the tree, so the ancestors are created first and own their descendants.
+    const struct node &n = mNodes[node];
+    QObject *parent = n.parent >= 0 ? wrapper(n.parent).data() : mOwner.data();
+    /// The element is created around the node shape, its geometry attributes are dropped when the shape is built.
+    QPointer<elements::element> el = utils::svgTools::elementGenerator(n.type, n.attributes, n.shape, parent);
+    if(!el) return nullptr;
+
+    el->bind(this, node);
+    /// The element constructor points the shape to the element's world transform, the node's is used while it's bound.
+    if(n.shape) n.shape->setTransform(&mWorld[node]);
+    mWrappers.insert(node, el);
+    if(mWrapperHook) mWrapperHook(el);
+    return el;
+}
+
+std::vector<QPointer<elements::element>> scene::wrappers() const {
+    QList<int> nodes = mWrappers.keys();
+    std::sort(nodes.begin(), nodes.end());
+    std::vector<QPointer<elements::element>> list;
+    list.reserve(nodes.size());
+    for(const int node: nodes) list.push_back(mWrappers.value(node));
+    return list;
+}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QRectF>
+#include <QString>
+#include <QTransform>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "shapes/shapes.h"
+#include "elements/element.h"
+#include "utils/atomtable.h"
+#include "utils/attributelist.h"
+
+namespace veqtor::core {
+/**
+ * @brief The scene class
+ * @abstract The document model, without QObjects. The nodes are stored contiguously in pre-order (the paint order)
+ *  and refer to each other by index, so the subtree of a node is the index range `[node, end)`.
+ *  Graphic nodes own their shape; the world state and the retained geometry are kept in arrays next to the nodes,
+ *  so a document is painted and hit-tested without any element.
+ *  QML-facing elements are only created on demand by `wrapper`, and they are bound to their nodes
+ *  (see `element::bind`). A scene without elements can be used from any thread, but only by one at a time.
+ */
+class scene {
+public:
+    using Type = elements::element::Type;
+
+    struct node {
+        Type type = Type::Unknown;
+        int parent = -1;
+        /// One past the last node of the subtree.
+        int end = 0;
+        /// Paint order index of a graphic node, otherwise -1.
+        int graphic = -1;
+        QString id;
+        /// The names are interned in the atom table of the scene. The shape attributes are dropped once the shape
+        ///  is built (see `svgTools::shapeAttributes`).
+        utils::attributeList attributes;
+        std::shared_ptr<shapes::shape> shape;
+        /// The local transform and opacity.
+        QTransform transform;
+        qreal opacity = 1.0;
+    };
+
+    scene() = default;
+    ~scene();
+
+    scene(const scene&) = delete;
+    scene &operator = (const scene&) = delete;
+
+    /**
+     * @brief open, close, finalize
+     * @abstract The scene is built in document order: `open` appends a node as a child of the innermost open node,
+     *  and `close` ends the innermost open node. `finalize` closes the remaining nodes and allocates the world state,
+     *  no node can be added after it.
+     * @return open returns the index of the node.
+     */
+    int open(Type type, utils::attributeList &&attrs, std::shared_ptr<shapes::shape> &&shape);
+    void close();
+    void finalize();
+
+    /// getters
+    int size() const { return static_cast<int>(mNodes.size()); }
+    bool empty() const { return mNodes.empty(); }
+    const node &operator[](int i) const { return mNodes[i]; }
+    /** @return The direct children of a node. */
+    std::vector<int> children(int node) const;
+    /** @return The node with the given id, or -1. */
+    int find(const QString &id) const { return mIds.value(id, -1); }
+    const QHash<QString, int> &ids() const { return mIds; }
+    /** @return The graphic nodes in paint order, their indices are the graphic ids. */
+    const std::vector<int> &graphics() const { return mGraphics; }
+    /** @return The graphic ids in the subtree of a node, as the range [first, second). */
+    std::pair<int, int> graphicRange(int node) const;
+    /** @return The table that the attribute names of the nodes (and their elements) are interned in. */
+    const std::shared_ptr<utils::atomTable> &atoms() const { return mAtoms; }
+    /** @return The view box of the root `<svg>` node. */
+    const QRectF &viewBox() const { return mViewBox; }
+
+    /**
+     * @brief world, worldOpacity
+     * @abstract The transform from the node coordinates to the root coordinates, and the opacity of the node
+     *  multiplied by the opacities of its ancestors. They are cached until the node or an ancestor changes.
+     */
+    const QTransform &world(int node) const;
+    qreal worldOpacity(int node) const;
+    /** @brief paintRect, The area covered by the shape (including half of the stroke width) in the root coordinates. */
+    QRectF paintRect(int node) const;
+    /** @brief contains, Hit-tests the shape of a node, @a point is in the root coordinates. */
+    bool contains(int node, const QPointF &point) const;
+    /** @return The retained geometry of a graphic node, otherwise nullptr. */
+    shapes::geometryCache *geometry(int node) const;
+
+    /// setters, the bound elements write their changes through them.
+    void setTransform(int node, const QTransform &transform);
+    void setOpacity(int node, qreal opacity);
+    void setId(int node, const QString &id);
+    void setViewBox(const QRectF &viewBox) { mViewBox = viewBox; }
+
+    /**
+     * @brief wrapper
+     * @abstract Returns the element of a node. It's created (after the elements of its ancestors) and bound
+     *  on the first call, in the calling thread. The root element is a child of the owner.
+     * @return The element, or nullptr if the index is invalid.
+     */
+    QPointer<elements::element> wrapper(int node);
+    /** @return The element of a node if it's created, otherwise nullptr. */
+    QPointer<elements::element> existingWrapper(int node) const { return mWrappers.value(node); }
+    /** @return The created elements in document order. */
+    std::vector<QPointer<elements::element>> wrappers() const;
+
+    void setOwner(QObject *owner) { mOwner = owner; }
+    /** @brief setWrapperHook, Sets a function that is called with each created element, after it's bound. */
+    void setWrapperHook(const std::function<void(elements::element *)> &hook) { mWrapperHook = hook; }
+
+private:
+    /// Drops the cached world state of the subtree of a node.
+    void invalidateWorld(int node);
+
+    std::vector<node> mNodes;
+    std::shared_ptr<utils::atomTable> mAtoms = std::make_shared<utils::atomTable>();
+    /// The open nodes while the scene is built.
+    std::vector<int> mOpen;
+    std::vector<int> mGraphics;
+    QHash<QString, int> mIds;
+    QRectF mViewBox;
+
+    /// World state of the nodes. The shapes point to their world transforms, so it's allocated once.
+    mutable std::vector<QTransform> mWorld;
+    mutable std::vector<qreal> mWorldOpacity;
+    mutable std::vector<char> mWorldValid;
+    /// Retained geometry of the graphic nodes, by graphic id.
+    mutable std::vector<shapes::geometryCache> mGeometry;
+
+    QHash<int, QPointer<elements::element>> mWrappers;
+    QPointer<QObject> mOwner;
+    std::function<void(elements::element *)> mWrapperHook;
+};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 
 #include "shape.h"
 #include "path.h"
@@ -25,7 +26,7 @@ public:
         : ellipse(QRectF(topLeft, bottomRight), pen) {}
 
     operator path() const {
-        path ps(mPen);
+        path ps(pen());
         const auto &bb = mBoundingBox;
         apoint c = center();
 
@@ -38,8 +39,7 @@ public:
             pd::close{}
         });
 
-        ps.setTransform(transformer());
-        ps.applyTransform();
+        ps.applyTransform(transformer());
         return ps;
     }
 
@@ -70,18 +70,28 @@ public:
 
     /**
      * @brief contains
+     * @abstract The distance to the outline is estimated from the ellipse equation and its gradient,
+     *  it's exact for circles.
      * @param point
      * @return
      * PointState::Inside If the ellipse is filled and the point is within the ellipse.
-     * PointState::Edge If the point is over the ellipse's outline.
+     * PointState::Edge If the point is within the stroke (or `edgeTolerance`) of the ellipse's outline.
      * PointState::None If none of the preceding statements are true.
      */
     PointState contains(const apoint &point) const override {
-        apoint rp = invertTransformer().map(point);
-        const qreal eeq = std::pow(rp.x() - mCenter.x(), 2) / std::pow(mRadius.width(), 2) +
-                          std::pow(rp.y() - mCenter.y(), 2) / std::pow(mRadius.height(), 2);
-        return mPen.mFill && eeq <= 0.9 ? PointState::Inside :
-               0.9 < eeq  && eeq <= 1.1 ? PointState::Edge : PointState::None;
+        const qreal a2 = mRadius.width() * mRadius.width(), b2 = mRadius.height() * mRadius.height();
+        if(a2 <= 0 || b2 <= 0) return PointState::None;
+
+        const apoint rp = invertTransformer().map(point);
+        const qreal dx = rp.x() - mCenter.x(), dy = rp.y() - mCenter.y();
+        /// f(p) / |∇f(p)| with f = eeq - 1, the center is inside and never on the outline.
+        const qreal eeq = dx * dx / a2 + dy * dy / b2;
+        const qreal gradient = 2 * std::hypot(dx / a2, dy / b2);
+        const qreal distance = isCircle()    ? std::hypot(dx, dy) - mRadius.width() :
+                               gradient > 0  ? (eeq - 1) / gradient :
+                                               -std::min(mRadius.width(), mRadius.height());
+        return std::abs(distance) <= edgeRadius() ? PointState::Edge :
+               distance < 0 && mPen->filled()      ? PointState::Inside : PointState::None;
     }
 
     /**
@@ -131,7 +141,7 @@ public:
         updateBoundingBox();
     }
     void setRadius(qreal rad) {
-        mRadius = QSize(rad, rad);
+        mRadius = QSizeF(rad, rad);
         updateBoundingBox();
     }
 
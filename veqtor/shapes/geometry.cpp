@@ -0,0 +1,71 @@
+#include "geometry.h"
+#include "path.h"
+#include "line.h"
+#include "series.h"
+
+#include "../utils/arctocubic.h"
+
+namespace veqtor::shapes {
+void geometry::build(const path &p) {
+    clear();
+    const pathbuffer &data = p.pathData();
+    mVerbs.reserve(data.size() + 1);
+    mCoords.reserve(2 * data.size() + 2);
+
+    /// @brief "current from" and "last move to" points, segments are already absolute so only arcs need them.
+    apoint from{}, lto{};
+
+    /// Add a moveTo at the beginning of the path if it doesn't start with one.
+    if(!data.empty() && data.front().verb != pathbuffer::Move) {
+        if(data.front().verb != pathbuffer::Close) from = lto = data.front().to();
+        push(Move);
+        push(from);
+    }
+
+    for(const pathbuffer::segment s: data) {
+        switch(s.verb) {
+            case pathbuffer::Close: push(Close); from = lto; continue;
+            case pathbuffer::Move: push(Move); lto = s.to(); break;
+            case pathbuffer::Line: push(Line); break;
+            case pathbuffer::Quad: push(Quad); break;
+            case pathbuffer::Cubic: push(Cubic); break;
+            case pathbuffer::Arc: {
+                const auto cubics = utils::arcTool::arcToCubic(from, s.to(), s.radius(), s.rotation(),
+                                                               s.largeArc(), s.sweepFlag());
+                /// An arc with a zero radius is a straight line.
+                if(cubics.isEmpty()) { push(Line); push(s.to()); }
+                for(const auto &cubic: cubics) {
+                    push(Cubic); push(cubic.c1); push(cubic.c2); push(cubic.to);
+                }
+                from = s.to();
+                continue;
+            }
+        }
+
+        mCoords.insert(mCoords.end(), s.coords, s.coords + pathbuffer::coordCount(s.verb));
+        from = s.to();
+    }
+}
+
+void geometry::build(const series &s) {
+    clear();
+    mVerbs.reserve(s.size());
+    mCoords.reserve(2 * s.size());
+
+    /// The mapping is only a scale and a translation, so it's applied inline.
+    const QTransform m = s.mapping();
+    const float sx = m.m11(), sy = m.m22(), dx = m.dx(), dy = m.dy();
+    s.forEachSpan([&](const float *xy, size_t count) {
+        for(size_t i = 0; i < count; ++i) {
+            const float x = sx * xy[2 * i] + dx, y = sy * xy[2 * i + 1] + dy;
+            empty() ? moveTo(x, y) : lineTo(x, y);
+        }
+    });
+}
+
+void geometry::build(const line &l) {
+    clear();
+    moveTo(l.x1(), l.y1());
+    lineTo(l.x2(), l.y2());
+}
+} // namespace veqtor::shapes
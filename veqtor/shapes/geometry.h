@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "apoint.h"
+
+namespace veqtor::shapes {
+class path;
+class series;
+class line;
+
+/**
+ * @brief The geometry class
+ * @abstract A retained, paint-ready command list of a path (or the polyline of a series or a line).
+ *  All coordinates are absolute, arcs are already converted to cubic curves and
+ *  shorthand curves (`s`, `t`) are expanded, so replaying it needs no further computation.
+ */
+class geometry {
+public:
+    enum Verb : std::uint8_t { Move, Line, Quad, Cubic, Close };
+
+    geometry() = default;
+    explicit geometry(const path &p) { build(p); }
+
+    /**
+     * @brief build
+     * @abstract Converts the path data to the command list, the old commands are removed.
+     * @param p, source path.
+     */
+    void build(const path &p);
+    /** @brief build, The points of the series as a polyline, mapped from its window to its viewport. */
+    void build(const series &s);
+    void build(const line &l);
+    void clear() { mVerbs.clear(); mCoords.clear(); }
+
+    void moveTo(float x, float y) { mVerbs.push_back(Move); mCoords.push_back(x); mCoords.push_back(y); }
+    void lineTo(float x, float y) { mVerbs.push_back(Line); mCoords.push_back(x); mCoords.push_back(y); }
+    /** @return true if the geometry has only straight segments (no curves or closed contours). */
+    bool isPolyline() const {
+        return std::all_of(mVerbs.cbegin(), mVerbs.cend(), [](Verb v) { return v == Move || v == Line; });
+    }
+
+    /// getters
+    bool empty() const { return mVerbs.empty(); }
+    const std::vector<Verb> &verbs() const { return mVerbs; }
+    /** @return x and y of all the points in command order (1 point for move/line, 2 for quad and 3 for cubic). */
+    const std::vector<float> &coords() const { return mCoords; }
+
+    /** @return number of coordinates used by the given verb. */
+    static constexpr int coordCount(Verb verb) {
+        return verb == Move || verb == Line ? 2 : verb == Quad ? 4 : verb == Cubic ? 6 : 0;
+    }
+
+private:
+    void push(Verb verb) { mVerbs.push_back(verb); }
+    void push(const apoint &p) {
+        mCoords.push_back(static_cast<float>(p.x()));
+        mCoords.push_back(static_cast<float>(p.y()));
+    }
+
+    std::vector<Verb> mVerbs;
+    std::vector<float> mCoords;
+};
+} // namespace veqtor::shapes
@@ -0,0 +1,91 @@
+#include <cmath>
+
+#include "geometrycache.h"
+#include "line.h"
+#include "path.h"
+#include "series.h"
+
+#include "../utils/decimator.h"
+
+namespace veqtor::shapes {
+const geometry *geometryCache::get(const shape &s) const {
+    const ShapeType type = s.type();
+    if(type != Path && type != Series && type != Line) return nullptr;
+
+    if(!mValid) {
+        geometry &g = writable(mGeometry);
+        switch(type) {
+            case Path: g.build(static_cast<const path &>(s)); break;
+            case Series: g.build(static_cast<const series &>(s)); break;
+            default: g.build(static_cast<const line &>(s)); break;
+        }
+        mValid = true;
+    }
+    return mGeometry.get();
+}
+
+const geometry *geometryCache::get(const shape &s, const QTransform &device) const {
+    if(!mDecimate) return get(s);
+
+    /// Columns are only well-defined if the x axis is not rotated or sheared.
+    if(device.type() > QTransform::TxScale) return get(s);
+
+    /// Moving by whole pixels does not change the columns, so only the fractional offset is compared.
+    const qreal offset = device.dx() - std::floor(device.dx());
+    if(!mLodValid || mLodScale != device.m11() || mLodOffset != offset) {
+        mLodUsed = buildLod(s, device.m11(), offset);
+        mLodScale = device.m11();
+        mLodOffset = offset;
+        mLodValid = true;
+    }
+    return mLodUsed ? mLod.get() : get(s);
+}
+
+std::shared_ptr<const geometry> geometryCache::share(const shape &s, const QTransform &device) const {
+    const geometry *g = get(s, device);
+    if(!g) return nullptr;
+    return g == mLod.get() ? mLod : mGeometry;
+}
+
+geometry &geometryCache::writable(std::shared_ptr<geometry> &g) {
+    if(!g || g.use_count() > 1) g = std::make_shared<geometry>();
+    return *g;
+}
+
+bool geometryCache::buildLod(const shape &s, qreal scale, qreal offset) const {
+    geometry &out = writable(mLod);
+    out.clear();
+    /// At most four points are kept per column, fewer points than that are not decimated.
+    const qreal columns = std::abs(scale) * s.boundingBox().width() + 1;
+
+    if(s.type() == Series) {
+        const auto &data = static_cast<const series &>(s);
+        if(data.size() <= 4 * columns) return false;
+
+        /// The envelope is built in the shape coordinates, so the series mapping is applied first.
+        const QTransform m = data.mapping();
+        const float sx = m.m11(), sy = m.m22(), dx = m.dx(), dy = m.dy();
+        utils::decimator lod(out, scale, offset);
+        bool first = true;
+        data.forEachSpan([&](const float *xy, size_t count) {
+            for(size_t i = 0; i < count; ++i) {
+                const float x = sx * xy[2 * i] + dx, y = sy * xy[2 * i + 1] + dy;
+                first ? lod.moveTo(x, y) : lod.lineTo(x, y);
+                first = false;
+            }
+        });
+        return true;
+    }
+
+    const geometry *geo = get(s);
+    if(!geo || !geo->isPolyline() || geo->verbs().size() <= 4 * columns) return false;
+
+    utils::decimator lod(out, scale, offset);
+    const float *c = geo->coords().data();
+    for(const auto verb: geo->verbs()) {
+        verb == geometry::Move ? lod.moveTo(c[0], c[1]) : lod.lineTo(c[0], c[1]);
+        c += 2;
+    }
+    return true;
+}
+} // namespace veqtor::shapes
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QTransform>
+
+#include <memory>
+
+#include "geometry.h"
+
+namespace veqtor::shapes {
+class shape;
+
+/**
+ * @brief The geometryCache class
+ * @abstract The retained geometry of a shape, and its decimated level of detail. It's kept next to the shape
+ *  (by a graphic element or by a scene node), and rebuilt lazily after it's invalidated.
+ *  A geometry that is shared by a snapshot (see `share`) is never changed, the cache is rebuilt into a new one.
+ */
+class geometryCache {
+public:
+    /**
+     * @brief get
+     * @abstract Paint commands of path shapes, so unchanged paths are neither re-parsed nor arcs re-converted
+     *  on every frame. Series and lines are retained as polylines.
+     * @return geometry of path, series and line shapes, otherwise nullptr.
+     */
+    const geometry *get(const shape &s) const;
+
+    /**
+     * @brief get
+     * @abstract If `decimate` is enabled, returns a per-pixel min/max envelope of polyline shapes (series,
+     *  or paths with only straight segments) for the given device transform, so the render cost is bounded by
+     *  the width of the shape in pixels instead of its number of points.
+     *  The envelope is cached until the cache is invalidated or the horizontal zoom changes.
+     * @param device, Transform from the shape coordinates to the device.
+     * @return The decimated geometry, otherwise the same as `get(s)`.
+     */
+    const geometry *get(const shape &s, const QTransform &device) const;
+    /** @brief share, The same as `get(s, device)`, shared with the caller until it releases it. */
+    std::shared_ptr<const geometry> share(const shape &s, const QTransform &device) const;
+
+    void invalidate() { mValid = mLodValid = false; }
+
+    bool decimate() const { return mDecimate; }
+    void setDecimate(bool decimate) {
+        mDecimate = decimate;
+        mLodValid = false;
+    }
+
+private:
+    /** @brief buildLod, Builds the envelope for the given device column mapping, returns false if it's not worthwhile. */
+    bool buildLod(const shape &s, qreal scale, qreal offset) const;
+    /** @return The geometry of @a g to rebuild, it's replaced by a new one if it's shared. */
+    static geometry &writable(std::shared_ptr<geometry> &g);
+
+    mutable std::shared_ptr<geometry> mGeometry;
+    mutable bool mValid = false;
+
+    bool mDecimate = false;
+    /// Decimated geometry and the column mapping (scale and fractional offset) that it's built for.
+    mutable std::shared_ptr<geometry> mLod;
+    mutable bool mLodValid = false;
+    mutable bool mLodUsed = false;
+    mutable qreal mLodScale = 0.0;
+    mutable qreal mLodOffset = 0.0;
+};
+} // namespace veqtor::shapes
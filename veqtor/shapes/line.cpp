@@ -3,7 +3,7 @@
 
 namespace veqtor::shapes {
 line::operator path() const {
-    path path({{p1(), pd::move{}}, {p2(), pd::line{}}}, mPen);
+    path path({{p1(), pd::move{}}, {p2(), pd::line{}}}, pen());
     return path;
 }
 }
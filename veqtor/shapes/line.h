@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 #include "shape.h"
 
 namespace veqtor::shapes {
@@ -13,7 +15,7 @@ public:
     enum LineType { None, Point, Line, Quad, Cubic, Arc };
 
     line(const QLineF& l = QLineF(), const core::nanoPen& pen = core::nanoPen())
-        : QLineF(l), shape(l, pen) {}
+        : QLineF(l), shape(QRectF(l.p1(), l.p2()).normalized(), pen) {}
     line(const apoint& p1, const apoint& p2, const core::nanoPen& pen = core::nanoPen())
         : line(QLineF(p1, p2), pen) {}
 
@@ -32,16 +34,21 @@ public:
      * @brief contains
      * check if point is over line or not.
      * @abstract
-     * for p1, p2 and p3, there is a p3 between p1 and p2
-     * if distance p1 and p3 plus to distance p3 and p2 are equal to
-     * distance p1 and p2.
+     * The point is projected on the segment, and it's over the line if its distance to
+     * the projection is within the stroke (or `edgeTolerance`).
      *  p1<---->p3<----------->p2
-     *   ^---------------------^
+     *          |
+     *          p
      * @param point
      * @return PointState::Edge or PointState::None
      */
     PointState contains(const apoint &point) const override {
-        return apoint(point).isBetween(p1(), p2()) ? PointState::Edge : PointState::None;
+        const apoint p = invertTransformer().map(point);
+        const qreal dx = x2() - x1(), dy = y2() - y1();
+        const qreal length2 = dx * dx + dy * dy;
+        const qreal t = length2 > 0 ? std::clamp(((p.x() - x1()) * dx + (p.y() - y1()) * dy) / length2, 0.0, 1.0) : 0.0;
+        const qreal distance = std::hypot(x1() + t * dx - p.x(), y1() + t * dy - p.y());
+        return distance <= edgeRadius() ? PointState::Edge : PointState::None;
     }
 
     /// getters
@@ -51,11 +58,21 @@ public:
     /// setters
     void setP1(const apoint &p) {
         QLineF::setP1(p);
-        mBoundingBox.setTopLeft(p);
+        updateBoundingBox();
     }
     void setP2(const apoint &p) {
         QLineF::setP2(p);
-        mBoundingBox.setBottomRight(p);
+        updateBoundingBox();
+    }
+    void setLine(const QLineF &l) {
+        QLineF::setPoints(l.p1(), l.p2());
+        updateBoundingBox();
+    }
+
+    /// The end points can be in any order, so the bounding box is normalized.
+    const QRectF &updateBoundingBox() override {
+        mBoundingBox = QRectF(p1(), p2()).normalized();
+        return mBoundingBox;
     }
 };
 }
@@ -1,48 +1,181 @@
+#include <cmath>
+
 #include "path.h"
+#include "geometry.h"
 
 namespace veqtor::shapes {
+/**
+ * @brief segmentDistance2
+ * @return The squared distance between point @a p and segment @a a - @a b.
+ */
+static qreal segmentDistance2(const apoint &p, const apoint &a, const apoint &b) {
+    const qreal dx = b.x() - a.x(), dy = b.y() - a.y();
+    const qreal length2 = dx * dx + dy * dy;
+    const qreal t = length2 > 0 ? std::clamp(((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / length2, 0.0, 1.0) : 0.0;
+    const qreal ex = a.x() + t * dx - p.x(), ey = a.y() + t * dy - p.y();
+    return ex * ex + ey * ey;
+}
+
+/**
+ * @brief windingOf
+ * @return The signed crossing of segment @a a - @a b with the horizontal ray that starts from @a p.
+ */
+static int windingOf(const apoint &p, const apoint &a, const apoint &b) {
+    const qreal side = (b.x() - a.x()) * (p.y() - a.y()) - (p.x() - a.x()) * (b.y() - a.y());
+    if(a.y() <= p.y()) return b.y() > p.y() && side > 0 ? 1 : 0;
+    return b.y() <= p.y() && side < 0 ? -1 : 0;
+}
+
+/**
+ * @brief segmentCount
+ * @abstract Wang's formula, the number of segments that keep a Bezier curve within the flattening tolerance.
+ * @param difference, The largest second difference of the control points.
+ * @param factor, degree * (degree - 1) / 8
+ */
+static int segmentCount(const QPointF &difference, qreal factor) {
+    const qreal length = std::hypot(difference.x(), difference.y());
+    return std::clamp(int(std::ceil(std::sqrt(factor * length / path::flatteningTolerance))), 1, 256);
+}
+
+const QRectF &path::updateBoundingBox() {
+    mBoundingBox = mPathData.bounds();
+    return mBoundingBox;
+}
+
 PointState path::contains(const apoint &point) const {
-    apoint ipoint = invertTransformer().map(point);
-    if(mBoundingBox.contains(ipoint) == false || mPathData.size() < 2) {
+    const apoint ipoint = invertTransformer().map(point);
+    const auto &points = flattened();
+    if(points.empty()) return PointState::None;
+
+    const qreal radius = edgeRadius();
+    if(!mFlatBounds.adjusted(-radius, -radius, radius, radius).contains(ipoint)) {
         return PointState::None;
-    } else {
-        apoint last = mPathData.front().to;
-        for(const pathdata& d : mPathData) {
-            if(!d.isMove() && !d.isClose() && ipoint.isBetween(last, d.to)) {
+    }
+
+    const qreal radius2 = radius * radius;
+    int winding = 0;
+
+    for(const contour &c: mContours) {
+        for(size_t i = c.begin; i < c.end; ++i) {
+            /// Open contours are implicitly closed for filling, but their closing edge is not stroked.
+            const bool closing = i + 1 == c.end;
+            const apoint &a = points[i], &b = closing ? points[c.begin] : points[i + 1];
+            if((!closing || c.closed) && segmentDistance2(ipoint, a, b) <= radius2) {
                 return PointState::Edge;
             }
-            last = d.to;
+            winding += windingOf(ipoint, a, b);
         }
+    }
+
+    if(!mPen->filled()) return PointState::None;
+    const bool inside = mPen->mFillRule == Qt::OddEvenFill ? (winding & 1) : winding != 0;
+    return inside ? PointState::Inside : PointState::None;
+}
+
+const std::vector<apoint> &path::flattened() const {
+    if(mFlatValid) return mFlatPoints;
 
-        if(mPathData.size() > 2) {
-            QLineF hLine(ipoint.x(), ipoint.y(), ipoint.x(), boundingBox().right() + 1);
-            apoint last = mPathData.front().to;
-            size_t intersects = 0;
+    mFlatPoints.clear();
+    mContours.clear();
 
-            for(const pathdata &d: mPathData) {
-                if(hLine.intersects(QLineF(last, d.to), nullptr) == QLineF::BoundedIntersection) {
-                    intersects++;
+    const geometry geo(*this);
+    const float *c = geo.coords().data();
+    apoint last;
+    size_t start = 0;
+
+    const auto finish = [&](bool closed) {
+        if(mFlatPoints.size() > start) mContours.push_back({start, mFlatPoints.size(), closed});
+        start = mFlatPoints.size();
+    };
+    /// Segments after a `close` start a new contour from the last point.
+    const auto begin = [&]() { if(mFlatPoints.size() == start) mFlatPoints.push_back(last); };
+
+    for(const geometry::Verb verb: geo.verbs()) {
+        switch(verb) {
+            case geometry::Move:
+                finish(false);
+                last = apoint{c[0], c[1]};
+                mFlatPoints.push_back(last);
+                break;
+            case geometry::Line:
+                begin();
+                last = apoint{c[0], c[1]};
+                mFlatPoints.push_back(last);
+                break;
+            case geometry::Quad: {
+                begin();
+                const apoint p0 = last, p1{c[0], c[1]}, p2{c[2], c[3]};
+                const int n = segmentCount(p0 - 2 * p1 + p2, 0.25);
+                for(int i = 1; i <= n; ++i) {
+                    const qreal t = qreal(i) / n, mt = 1 - t;
+                    mFlatPoints.push_back(mt * mt * p0 + 2 * mt * t * p1 + t * t * p2);
                 }
-                last = d.to;
+                last = p2;
+                break;
             }
-            return intersects % 2 == 1 ? PointState::Inside : PointState::None;
+            case geometry::Cubic: {
+                begin();
+                const apoint p0 = last, p1{c[0], c[1]}, p2{c[2], c[3]}, p3{c[4], c[5]};
+                const QPointF d1 = p0 - 2 * p1 + p2, d2 = p1 - 2 * p2 + p3;
+                const int n = segmentCount(std::hypot(d1.x(), d1.y()) > std::hypot(d2.x(), d2.y()) ? d1 : d2, 0.75);
+                for(int i = 1; i <= n; ++i) {
+                    const qreal t = qreal(i) / n, mt = 1 - t;
+                    mFlatPoints.push_back(mt * mt * mt * p0 + 3 * mt * mt * t * p1 + 3 * mt * t * t * p2 + t * t * t * p3);
+                }
+                last = p3;
+                break;
+            }
+            case geometry::Close:
+                if(mFlatPoints.size() > start) last = mFlatPoints[start];
+                finish(true);
+                break;
         }
-        return PointState::None;
+        c += geometry::coordCount(verb);
     }
+    finish(false);
+
+    mFlatBounds = QRectF();
+    if(!mFlatPoints.empty()) {
+        qreal left = mFlatPoints.front().x(), right = left;
+        qreal top = mFlatPoints.front().y(), bottom = top;
+        for(const apoint &p: mFlatPoints) {
+            left = std::min(left, p.x()); right = std::max(right, p.x());
+            top = std::min(top, p.y()); bottom = std::max(bottom, p.y());
+        }
+        mFlatBounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+    }
+
+    mFlatValid = true;
+    return mFlatPoints;
 }
 
 void path::push(char type, QPointF to, const QVariantMap &data, bool relative) {
-    mPathData.push_back({type, to, data, relative});
+    mPathData.push(pathdata{type, to, data, relative});
+    invalidate();
 }
 
 void path::vTo(qreal y, bool relative) {
-    mPathData.push_back({invertTransformer().map(apoint{0.0f, y}), pd::vr{}, relative});
-    expandBoundigBox(apoint{0.0f, y});
+    if(transformer().isIdentity()) {
+        mPathData.vTo(y, relative);
+    } else {
+        /// The line is vertical in the root coordinates, so the current point is mapped there and back.
+        apoint p = transformer().map(mPathData.current());
+        p.setY(relative ? p.y() + y : y);
+        mPathData.lineTo(invertTransformer().map(p));
+    }
+    invalidate();
 }
 
 void path::hTo(qreal x, bool relative) {
-    mPathData.push_back({invertTransformer().map(apoint{x, 0.0f}), pd::hr{}, relative});
-    expandBoundigBox(apoint{x, 0.0f});
+    if(transformer().isIdentity()) {
+        mPathData.hTo(x, relative);
+    } else {
+        /// The line is horizontal in the root coordinates, so the current point is mapped there and back.
+        apoint p = transformer().map(mPathData.current());
+        p.setX(relative ? p.x() + x : x);
+        mPathData.lineTo(invertTransformer().map(p));
+    }
+    invalidate();
 }
 
 void path::moveTo(std::vector<double> points, bool relative) {
@@ -55,8 +188,8 @@ void path::moveTo(std::vector<double> points, bool relative) {
 }
 
 void path::moveTo(apoint to, bool relative) {
-    mPathData.push_back({invertTransformer().map(to), pd::move{}, relative});
-    expandBoundigBox(to);
+    mPathData.moveTo(local(to, relative), relative);
+    invalidate();
 }
 
 void path::lineTo(const std::vector<double> &points, bool relative) {
@@ -68,28 +201,23 @@ void path::lineTo(const std::vector<double> &points, bool relative) {
 }
 
 void path::lineTo(apoint to, bool relative) {
-    mPathData.push_back({invertTransformer().map(to), pd::line{}, relative});
-    expandBoundigBox(to);
+    mPathData.lineTo(local(to, relative), relative);
+    invalidate();
 }
 
 void path::quadTo(const apoint &control, const apoint &to, bool relative) {
-    mPathData.push_back({invertTransformer().map(to),
-                         pd::quad{invertTransformer().map(control)},
-                         relative});
-    expandBoundigBox(to);
+    mPathData.quadTo(local(control, relative), local(to, relative), relative);
+    invalidate();
 }
 
 void path::shortQuadTo(const apoint &to, bool relative) {
-    mPathData.push_back({invertTransformer().map(to), pd::tquad{}, relative});
+    mPathData.shortQuadTo(local(to, relative), relative);
+    invalidate();
 }
 
 void path::cubicTo(const apoint &c1, const apoint &c2, const apoint &to, bool relative) {
-    mPathData.push_back({
-                         invertTransformer().map(to),
-        pd::cubic{invertTransformer().map(c1), invertTransformer().map(c2)},
-        relative
-    });
-    expandBoundigBox(to);
+    mPathData.cubicTo(local(c1, relative), local(c2, relative), local(to, relative), relative);
+    invalidate();
 }
 
 void path::cubicTo(const std::vector<double> &v, bool relative) {
@@ -101,16 +229,13 @@ void path::cubicTo(const std::vector<double> &v, bool relative) {
 }
 
 void path::shortCubicTo(const apoint &control, const apoint &to, bool relative) {
-    mPathData.push_back({invertTransformer().map(to), pd::scubic{control}, relative});
-    expandBoundigBox(to);
+    mPathData.shortCubicTo(local(control, relative), local(to, relative), relative);
+    invalidate();
 }
 
 void path::arcTo(apoint to, QSizeF radius, qreal xrot, bool larc, bool sweep, bool relative) {
-    mPathData.push_back({
-                         invertTransformer().map(to), pd::arc{radius, xrot, larc, sweep},
-                         relative
-    });
-    expandBoundigBox(to);
+    mPathData.arcTo(local(to, relative), radius, xrot, larc, sweep, relative);
+    invalidate();
 }
 
 void path::arcTo(const std::vector<double> &v, bool relative) {
@@ -122,11 +247,23 @@ void path::arcTo(const std::vector<double> &v, bool relative) {
 }
 
 void path::close() {
-    mPathData.push_back(pd::close{});
+    mPathData.close();
+    invalidate();
 }
 
-void path::setPathData(const std::vector<pathdata> &pathData) {
+void path::setPathData(const pathbuffer &pathData) {
     mPathData = pathData;
-    updateBoundingBox();
+    invalidate();
+}
+
+void path::setPathData(pathbuffer &&pathData) {
+    mPathData = std::move(pathData);
+    invalidate();
+}
+
+apoint path::local(const apoint &p, bool relative) const {
+    const QTransform inverse = invertTransformer();
+    /// Relative points are offsets, so they're not translated.
+    return relative ? apoint(inverse.map(p) - inverse.map(QPointF())) : apoint(inverse.map(p));
 }
 }
@@ -1,158 +1,44 @@
 #pragma once
 
-#include <limits>
 #include <algorithm>
-#include <QVariant>
 
-#include "apoint.h"
+#include "pathbuffer.h"
 #include "shape.h"
 
 namespace veqtor::shapes {
-namespace pd {
-    struct move  { };
-    struct line  { };
-    struct hr    { };
-    struct vr    { };
-    struct quad  { apoint control; };
-    struct tquad { apoint control; };
-    struct cubic { apoint c1, c2; };
-    struct scubic{ apoint control; };
-    struct arc   { QSizeF radius; qreal rotation; bool largeArc, sweepFlag; };
-    struct close { };
-}  // namespace pd
-
-struct pathdata {
-    using path_data =
-        std::variant<pd::close, pd::move, pd::line, pd::vr, pd::hr, pd::arc,
-                     pd::quad, pd::tquad, pd::cubic, pd::scubic>;
-    using real_limit = std::numeric_limits<qreal>;
-    enum Type {Close, Move, Line, Vr, Hr, Arc, Quad, ShortQuad, Cubic, ShortCubic};
-
-    pathdata(const pd::close& data): relative{}, to{}, data{data} {}
-    pathdata(const apoint& point, const path_data& data, bool relative = false)
-        : relative{relative}, to{point}, data{data} {}
-    pathdata(char type, const apoint& point, const QVariantMap& vdata, bool relative = false)
-        : relative{relative}, to{point} {
-        switch(std::tolower(type)) {
-        case 'm': data = pd::move{}; break;
-        case 'l': data = pd::line{}; break;
-        case 'v': data = pd::vr{}; break;
-        case 'h': data = pd::hr{}; break;
-        case 'q': data = pd::quad{vdata["control"].toPointF()}; break;
-        case 't': data = pd::tquad{}; break;
-        case 'c': data = pd::cubic{vdata["control1"].toPointF(), vdata["control2"].toPointF()}; break;
-        case 's': data = pd::scubic{vdata["control"].toPointF()}; break;
-        case 'a': data = pd::arc{vdata["radius"].toSizeF(), vdata["rotation"].toDouble(),
-                                 vdata["largeArc"].toBool(), vdata["sweepFlag"].toBool()}; break;
-        case 'z': default: data = pd::close{};
-        }
-    }
-    pathdata(const QVariantMap &map)
-        : pathdata(map["type"].toChar().toLatin1(), map["to"].toPointF(),
-                   map["data"].toMap(), map["relative"].toBool()) {}
-
-    Type type() const { return static_cast<Type>(data.index()); }
-    char typeChar() const { return "zmlvhaqc"[data.index()]; }
-
-    bool isVr() const { return data.index() == Vr; }
-    bool isHr() const { return data.index() == Hr; }
-    bool isMove() const { return data.index() == Move; }
-    bool isLine() const { return data.index() == Line; }
-    bool isArc()  const { return data.index() == Arc; }
-    bool isQuad() const { return data.index() == Quad; }
-    bool isCubic() const { return data.index() == Cubic; }
-    bool isShortQuad() const { return data.index() == ShortQuad; }
-    bool isShortCubic() const { return data.index() == ShortCubic; }
-    bool isClose() const { return data.index() == Close; }
-
-    pd::scubic scubic() const { return std::get<pd::scubic>(data); }
-    pd::scubic &scubic() { return std::get<pd::scubic>(data); }
-    pd::cubic cubic() const { return std::get<pd::cubic>(data); }
-    pd::cubic &cubic() { return std::get<pd::cubic>(data); }
-    pd::tquad tquad() const { return std::get<pd::tquad>(data); }
-    pd::tquad &tquad() { return std::get<pd::tquad>(data); }
-    pd::quad quad() const { return std::get<pd::quad>(data); }
-    pd::quad &quad() { return std::get<pd::quad>(data); }
-    pd::arc arc() const { return std::get<pd::arc>(data); }
-    pd::arc &arc() { return std::get<pd::arc>(data); }
-
-    QVariantMap map() const {
-        QVariantMap value{{"relative", relative},{"to", to}};
-        value["type"] = QChar("vhmlaqcz"[data.index()]);
-        if(isCubic()) { value["control"] = QVariantList{{cubic().c1, cubic().c2}}; }
-        else if(isQuad()) { value["control"] = quad().control; }
-        else if(isArc()) {
-            value.insert({
-                {"radius",   arc().radius   },
-                {"rotation", arc().rotation },
-                {"sweep",    arc().sweepFlag},
-                {"largeArc", arc().largeArc },
-            });
-        }
-        return value;
-    }
-
-    bool relative;
-    apoint to;
-    path_data data;
-};
-
 /** @brief The path shape class */
 class path : public shape {
 public:
     path(const core::nanoPen &pen = core::nanoPen())
-        : shape(pen), mPathData({}) {}
-    path(const std::vector<pathdata>& pdata, const core::nanoPen &pen = core::nanoPen())
+        : shape(pen) {}
+    path(const pathbuffer& pdata, const core::nanoPen &pen = core::nanoPen())
         : shape(pen), mPathData(pdata) {}
 
-    pathdata &operator[](size_t index) { return mPathData.at(index); }
-    const pathdata &operator[](size_t index) const { return mPathData.at(index); }
-
-    pathdata &at(size_t index) { return mPathData.at(index); }
-    const pathdata &at(size_t index) const { return mPathData.at(index); }
-
-    std::vector<pathdata>::iterator begin() { return mPathData.begin(); }
-    std::vector<pathdata>::const_iterator cbegin() const { return mPathData.cbegin(); }
-    std::vector<pathdata>::reverse_iterator rbegin() { return mPathData.rbegin(); }
-    std::vector<pathdata>::iterator end() { return mPathData.end(); }
-    std::vector<pathdata>::const_iterator cend() const { return mPathData.cend(); }
-    std::vector<pathdata>::reverse_iterator rend() { return mPathData.rend(); }
-    std::vector<pathdata>::const_reference front() const { return mPathData.front();}
-    std::vector<pathdata>::const_reference back() const { return mPathData.back();}
-
-    const QRectF& updateBoundingBox() override {
-        mBoundingBox = empty() ? QRectF{} : QRectF{front().to, QSizeF{}};
-        for(pathdata& p : mPathData) {
-            if(p.type() > pathdata::Move){
-                expandBoundigBox(p.to);
-            }
-        }
-
-        return mBoundingBox;
-    }
+    /// NOTE: Segments are stored as absolute coordinates, relative segments are resolved when they're added.
+    pathdata operator[](size_t index) const { return mPathData.at(index); }
+    pathdata at(size_t index) const { return mPathData.at(index); }
 
-    void pop() { mPathData.pop_back(); }
-    void leftShift() { mPathData.erase(mPathData.begin()); }
+    pathbuffer::const_iterator begin() const { return mPathData.begin(); }
+    pathbuffer::const_iterator cbegin() const { return mPathData.begin(); }
+    pathbuffer::const_iterator end() const { return mPathData.end(); }
+    pathbuffer::const_iterator cend() const { return mPathData.end(); }
+    pathbuffer::segment front() const { return mPathData.front(); }
+    pathbuffer::segment back() const { return mPathData.back(); }
+
+    /** @brief updateBoundingBox, bounds of the points and control points (see `pathbuffer::bounds`). */
+    const QRectF& updateBoundingBox() override;
+
+    void pop() { mPathData.pop(); invalidate(); }
+    void leftShift() { mPathData.popFront(); invalidate(); }
 
     /**
      * @brief applyTransform
-     * Sets angle to zero, and changes points and thier controls depend on shape rotation.
-     * NOTE: only path can reset it's bounding box (other shapes can't).
+     * Maps the points and their controls by @a transform, e.g. to bake a transform into a new path.
+     * NOTE: The world transform is shared with the element (or the scene node), so it's not changed.
      */
-    void applyTransform() {
-        if(!transformer().isIdentity()) {
-            for(pathdata& pdata : mPathData) {
-                pdata.to.transform(transformer());
-                if(pdata.type() == pathdata::Cubic) {
-                    std::get<pd::cubic>(pdata.data).c1.transform(transformer());
-                    std::get<pd::cubic>(pdata.data).c2.transform(transformer());
-                } else if(pdata.type() == pathdata::Quad) {
-                    std::get<pd::quad>(pdata.data).control.transform(transformer());
-                }
-            }
-        }
-        setTransform(QTransform());
-        updateBoundingBox();
+    void applyTransform(const QTransform &transform) {
+        mPathData.transform(transform);
+        invalidate();
     }
 
     /** @brief isNull, return shape type */
@@ -168,14 +54,34 @@ public:
     /**
      * @brief contains
      * check wheater if a point is inside a path or not.
-     * if shape is not filled function only check the edges and anchors.
+     * The path is flattened once (see `flattened`), so the cost of each query is bounded by the segment count.
+     * if shape is not filled function only check the edges (within half of the stroke width).
+     * Filled paths use the pen fill rule (nonzero or even-odd) for the inside test.
      * @param point
-     * @return true if path contain point, otherwise return false.
+     * @return PointState::Edge if the point is over the outline, PointState::Inside if it is inside of
+     *  a filled path, otherwise PointState::None.
      */
     PointState contains(const apoint &point) const override;
 
-    void clear() { mPathData.clear(); }
-    void push(const pathdata &l) { mPathData.push_back(l); }
+    /** @brief The contour struct, a range of points in the flattened path. */
+    struct contour { size_t begin, end; bool closed; };
+
+    /**
+     * @brief flattened
+     * @abstract Flattens curves and arcs to line segments within `flatteningTolerance`.
+     *  The result is cached until the path data changes.
+     * @return flattened points in absolute coordinates, use `contours` to split them.
+     */
+    const std::vector<apoint> &flattened() const;
+    const std::vector<contour> &contours() const { flattened(); return mContours; }
+    /** @return bounds of the flattened path, including curve extremes. */
+    const QRectF &flattenedBounds() const { flattened(); return mFlatBounds; }
+
+    /// Maximum distance (in path units) between the flattened segments and the curves.
+    static constexpr qreal flatteningTolerance = 0.1;
+
+    void clear() { mPathData.clear(); invalidate(); }
+    void push(const pathdata &l) { mPathData.push(l); invalidate(); }
     void push(char type, QPointF to, const QVariantMap &data, bool relative = false);
 
     void vTo(qreal y, bool relative = false);
@@ -193,16 +99,45 @@ public:
     void arcTo(const std::vector<double> &v, bool relative = false);
     void close();
 
+    /**
+     * @brief set
+     * @abstract Replaces the segment at @a index, a relative segment is resolved from the previous one.
+     */
+    void set(size_t index, const pathdata &data) { if(mPathData.set(index, data)) invalidate(); }
+    /** @brief setPoint, moves the end point of the segment at @a index. */
+    void setPoint(size_t index, const apoint &to) { if(mPathData.setPoint(index, to)) invalidate(); }
+    /**
+     * @brief setPoints
+     * @abstract Moves the end points of the segments in [@a first, @a last) to the same indices of @a points,
+     *  the caches are updated once for all of them.
+     */
+    template<class Points> void setPoints(size_t first, size_t last, const Points &points) {
+        last = std::min(last, size());
+        for(size_t i = first; i < last; ++i) mPathData.setPoint(i, points[i]);
+        if(first < last) invalidate();
+    }
+
     /// setters
-    void setPathData(const std::vector<pathdata> &pathData);
+    void setPathData(const pathbuffer &pathData);
+    void setPathData(pathbuffer &&pathData);
 
     /// getters
     bool singlePoint() const { return size() == 1; }
     bool empty() const { return mPathData.empty(); }
-    const std::vector<pathdata>& pathData() const { return mPathData; }
+    const pathbuffer& pathData() const { return mPathData; }
     size_t size() const { return mPathData.size(); }
 
 private:
-    std::vector<pathdata> mPathData;
+    /** @brief invalidate, called after each change, the bounds only update the changed blocks (see `pathbuffer`). */
+    void invalidate() { mFlatValid = false; mBoundingBox = mPathData.bounds(); }
+    /** @return The given point (or offset if it's relative) in the path coordinates. */
+    apoint local(const apoint &p, bool relative) const;
+
+    pathbuffer mPathData;
+
+    mutable bool mFlatValid = false;
+    mutable std::vector<apoint> mFlatPoints;
+    mutable std::vector<contour> mContours;
+    mutable QRectF mFlatBounds;
 };
 }
@@ -0,0 +1,499 @@
+#include <cmath>
+#include <algorithm>
+
+#include <QtMath>
+
+#include "pathbuffer.h"
+#include "../utils/arctocubic.h"
+
+namespace veqtor::shapes {
+using utils::simdTools;
+
+pathbuffer::pathbuffer(std::initializer_list<pathdata> segments) {
+    mVerbs.reserve(segments.size());
+    for(const pathdata &segment: segments) push(segment);
+}
+
+void pathbuffer::moveTo(const apoint &to, bool relative) {
+    const apoint p = absolute(to, relative);
+    push(Move); push(p);
+    mStartIndex = mVerbs.size() - 1;
+    mCurrent = mStart = p;
+}
+
+void pathbuffer::lineTo(const apoint &to, bool relative) {
+    const apoint p = absolute(to, relative);
+    push(Line); push(p);
+    mCurrent = p;
+}
+
+void pathbuffer::hTo(qreal x, bool relative) {
+    lineTo(apoint{relative ? mCurrent.x() + x : x, mCurrent.y()});
+}
+
+void pathbuffer::vTo(qreal y, bool relative) {
+    lineTo(apoint{mCurrent.x(), relative ? mCurrent.y() + y : y});
+}
+
+void pathbuffer::quadTo(const apoint &control, const apoint &to, bool relative) {
+    const apoint p = absolute(to, relative);
+    push(Quad); push(absolute(control, relative)); push(p);
+    mCurrent = p;
+}
+
+void pathbuffer::shortQuadTo(const apoint &to, bool relative) {
+    quadTo(reflection(Quad), absolute(to, relative));
+}
+
+void pathbuffer::cubicTo(const apoint &c1, const apoint &c2, const apoint &to, bool relative) {
+    const apoint p = absolute(to, relative);
+    push(Cubic); push(absolute(c1, relative)); push(absolute(c2, relative)); push(p);
+    mCurrent = p;
+}
+
+void pathbuffer::shortCubicTo(const apoint &c2, const apoint &to, bool relative) {
+    cubicTo(reflection(Cubic), absolute(c2, relative), absolute(to, relative));
+}
+
+void pathbuffer::arcTo(const apoint &to, const QSizeF &radius, qreal rotation, bool largeArc, bool sweepFlag,
+                       bool relative) {
+    const apoint p = absolute(to, relative);
+    push(Arc);
+    push(apoint{radius.width(), radius.height()});
+    mCoords.push_back(float(rotation));
+    mCoords.push_back(float((largeArc ? 1 : 0) | (sweepFlag ? 2 : 0)));
+    push(p);
+    mCurrent = p;
+}
+
+void pathbuffer::close() {
+    push(Close);
+    /// The subpath start is the first point if there is no move.
+    updateEnds();
+}
+
+void pathbuffer::push(const pathdata &d) {
+    switch(d.type()) {
+        case pathdata::Close: close(); break;
+        case pathdata::Move: moveTo(d.to, d.relative); break;
+        case pathdata::Line: lineTo(d.to, d.relative); break;
+        case pathdata::Hr: hTo(d.to.x(), d.relative); break;
+        case pathdata::Vr: vTo(d.to.y(), d.relative); break;
+        case pathdata::Quad: quadTo(d.quad().control, d.to, d.relative); break;
+        case pathdata::ShortQuad: shortQuadTo(d.to, d.relative); break;
+        case pathdata::Cubic: cubicTo(d.cubic().c1, d.cubic().c2, d.to, d.relative); break;
+        case pathdata::ShortCubic: shortCubicTo(d.scubic().control, d.to, d.relative); break;
+        case pathdata::Arc: {
+            const pd::arc arc = d.arc();
+            arcTo(d.to, arc.radius, arc.rotation, arc.largeArc, arc.sweepFlag, d.relative);
+            break;
+        }
+    }
+}
+
+bool pathbuffer::set(size_t index, const pathdata &data) {
+    if(index >= size()) return false;
+    const size_t p = mHead + index;
+
+    /// The new segment is resolved in a scratch buffer which ends with the previous segment,
+    ///  so relative points and shorthand curves get the same result as appending it there.
+    pathbuffer scratch;
+    if(index > 0) {
+        const segment previous = physical(p - 1);
+        scratch.mVerbs.push_back(previous.verb);
+        scratch.mCoords.assign(previous.coords, previous.coords + coordCount(previous.verb));
+        scratch.mStart = subpathStart(p);
+        scratch.mCurrent = previous.verb == Close ? scratch.mStart : previous.to();
+    }
+    scratch.push(data);
+
+    const segment s = scratch.back();
+    const Verb old = mVerbs[p];
+    const int oldCount = coordCount(old), newCount = coordCount(s.verb);
+    if(oldCount != newCount) resizeSegment(p, oldCount, newCount);
+    std::copy_n(s.coords, newCount, mCoords.begin() + coordOf(p));
+    mVerbs[p] = s.verb;
+    markChanged(p, old == Move);
+
+    if(old != s.verb && (old == Move || s.verb == Move)) {
+        /// The next blocks of the subpath start at the new move, or at the move before the removed one.
+        const size_t before = lastMove(p);
+        const size_t from = old == Move ? p : before, to = old == Move ? before : p;
+        for(size_t b = p / blockSize + 1; b < mBlockMoves.size() && mBlockMoves[b] == from; ++b) mBlockMoves[b] = to;
+        /// Adding or removing a move after the last subpath start changes the start.
+        if(mStartIndex == npos || p >= mStartIndex) mStartIndex = liveMove(mVerbs.size());
+    }
+    updateEnds();
+
+    if(mGarbage > mCoords.size() / 2) compact();
+    return true;
+}
+
+bool pathbuffer::setPoint(size_t index, const apoint &to) {
+    if(index >= size()) return false;
+    const size_t p = mHead + index;
+    if(mVerbs[p] == Close) return true;
+
+    float *c = mCoords.data() + coordOf(p) + coordCount(mVerbs[p]) - 2;
+    c[0] = float(to.x());
+    c[1] = float(to.y());
+    markChanged(p);
+    updateEnds();
+    return true;
+}
+
+pathdata pathbuffer::at(size_t index) const {
+    const segment s = (*this)[index];
+    switch(s.verb) {
+        case Move: return {s.to(), pd::move{}};
+        case Line: return {s.to(), pd::line{}};
+        case Quad: return {s.to(), pd::quad{s.point(0)}};
+        case Cubic: return {s.to(), pd::cubic{s.point(0), s.point(1)}};
+        case Arc: return {s.to(), pd::arc{s.radius(), s.rotation(), s.largeArc(), s.sweepFlag()}};
+        case Close: default: return pd::close{};
+    }
+}
+
+void pathbuffer::pop() {
+    if(empty()) return;
+
+    const size_t p = mVerbs.size() - 1;
+    mCoords.resize(mCoords.size() - coordCount(mVerbs.back()));
+    mVerbs.pop_back();
+    const bool emptyBlock = mVerbs.size() % blockSize == 0;
+    if(emptyBlock) {
+        mBlocks.pop_back();
+        mBlockMoves.pop_back();
+    }
+    if(empty()) {
+        clear();
+        return;
+    }
+    if(emptyBlock) moveTail();
+
+    markDirty(p / blockSize);
+    mPending = std::min(mPending, mVerbs.size());
+    if(p == mStartIndex) mStartIndex = liveMove(p);
+    updateEnds();
+}
+
+void pathbuffer::popFront() {
+    if(empty()) return;
+
+    const size_t p = mHead;
+    mHeadCoords += coordCount(mVerbs[p]);
+    mGarbage += coordCount(mVerbs[p]);
+    ++mHead;
+    if(empty()) {
+        clear();
+        return;
+    }
+
+    if(mHead % blockSize == 0) mHeadCoords = mBlocks[mHead / blockSize];
+    if(mStartIndex != npos && mStartIndex < mHead) mStartIndex = npos;
+    updateEnds();
+
+    if(mHead >= size()) compact();
+    else {
+        /// The first segment starts at its own point now, it matters if it's an arc.
+        markDirty(p / blockSize);
+        markDirty(mHead / blockSize);
+    }
+}
+
+void pathbuffer::clear() {
+    mVerbs.clear();
+    mCoords.clear();
+    mBlocks.clear();
+    mBlockMoves.clear();
+    mHead = mHeadCoords = mGarbage = 0;
+    mStartIndex = npos;
+    mCurrent = mStart = apoint{};
+
+    mTree.clear();
+    mLeaves = 0;
+    mDirty.clear();
+    mDirtyBlocks.clear();
+    mPending = 0;
+}
+
+void pathbuffer::squeeze() {
+    if(mHead || mGarbage) compact();
+    if(mVerbs.capacity() > 2 * mVerbs.size()) mVerbs.shrink_to_fit();
+    if(mCoords.capacity() > 2 * mCoords.size()) mCoords.shrink_to_fit();
+}
+
+void pathbuffer::transform(const QTransform &t) {
+    if(t.isIdentity() || empty()) return;
+
+    /// Scale of the x and y axes and the rotation of the x axis, used for the arc parameters.
+    const float sx = std::hypot(t.m11(), t.m12()), sy = std::hypot(t.m21(), t.m22());
+    const float rotation = qRadiansToDegrees(std::atan2(t.m12(), t.m11()));
+    const bool mirrored = t.determinant() < 0;
+
+    /// The points of consecutive segments of a block are packed, so they're mapped in bulk until an arc.
+    for(size_t b = mHead / blockSize; b < mBlocks.size(); ++b) {
+        const size_t first = std::max(b * blockSize, mHead), last = std::min((b + 1) * blockSize, mVerbs.size());
+        float *c = mCoords.data() + (first == mHead ? mHeadCoords : mBlocks[b]), *run = c;
+        for(size_t i = first; i < last; ++i) {
+            if(mVerbs[i] == Arc) {
+                simdTools::transform(run, (c - run) / 2, t);
+                c[0] *= sx;
+                c[1] *= sy;
+                c[2] += rotation;
+                /// A mirrored arc is drawn in the opposite direction.
+                if(mirrored) c[3] = float(int(c[3]) ^ 2);
+                simdTools::transform(c + 4, 1, t);
+                run = c + coordCount(Arc);
+            }
+            c += coordCount(mVerbs[i]);
+        }
+        simdTools::transform(run, (c - run) / 2, t);
+    }
+
+    updateEnds();
+    resetBounds();
+}
+
+QRectF pathbuffer::bounds() const {
+    updateBounds();
+    return mLeaves ? mTree[1].rect() : QRectF();
+}
+
+void pathbuffer::push(Verb verb) {
+    if(mVerbs.size() % blockSize == 0) {
+        /// It's searched once per block, the moves of the removed head are kept like the other blocks.
+        mBlockMoves.push_back(lastMove(mVerbs.size()));
+        mBlocks.push_back(std::uint32_t(mCoords.size()));
+    }
+    mVerbs.push_back(verb);
+}
+
+apoint pathbuffer::reflection(Verb verb) const {
+    if(empty() || mVerbs.back() != verb) return mCurrent;
+    /// The last control point of both quad and cubic curves is right before the end point.
+    const float *control = mCoords.data() + mCoords.size() - 4;
+    return 2 * mCurrent - apoint{control[0], control[1]};
+}
+
+size_t pathbuffer::coordOf(size_t p) const {
+    size_t c = mBlocks[p / blockSize];
+    for(size_t i = p - p % blockSize; i < p; ++i) c += coordCount(mVerbs[i]);
+    return c;
+}
+
+void pathbuffer::updateEnds() {
+    /// The subpath starts at the last move, or at the first point if the path doesn't start with a move.
+    if(mStartIndex != npos) mStart = physical(mStartIndex).to();
+    else mStart = front().verb != Close ? front().to() : apoint{};
+    mCurrent = back().verb == Close ? mStart : back().to();
+}
+
+size_t pathbuffer::lastMove(size_t p) const {
+    if(p == 0) return npos;
+    const size_t block = (p - 1) / blockSize;
+    for(size_t i = p; i-- > block * blockSize;) {
+        if(mVerbs[i] == Move) return i;
+    }
+    return mBlockMoves[block];
+}
+
+apoint pathbuffer::subpathStart(size_t p) const {
+    const size_t move = liveMove(p);
+    if(move != npos) return physical(move).to();
+    return front().verb != Close ? front().to() : apoint{};
+}
+
+size_t pathbuffer::blockEnd(size_t block) const {
+    size_t c = mBlocks[block];
+    const size_t last = std::min((block + 1) * blockSize, mVerbs.size());
+    for(size_t i = block * blockSize; i < last; ++i) c += coordCount(mVerbs[i]);
+    return c;
+}
+
+void pathbuffer::resizeSegment(size_t p, int oldCount, int newCount) {
+    const size_t block = p / blockSize;
+    const size_t first = mBlocks[block], last = blockEnd(block);
+    /// The coordinates after the segment.
+    const size_t at = coordOf(p) + oldCount;
+
+    if(block + 1 == mBlocks.size()) {
+        if(newCount > oldCount) mCoords.insert(mCoords.begin() + at, newCount - oldCount, 0.0f);
+        else mCoords.erase(mCoords.begin() + at - (oldCount - newCount), mCoords.begin() + at);
+        return;
+    }
+    if(newCount < oldCount) {
+        std::copy(mCoords.begin() + at, mCoords.begin() + last, mCoords.begin() + at - (oldCount - newCount));
+        mGarbage += oldCount - newCount;
+        return;
+    }
+
+    const size_t offset = mCoords.size(), grow = size_t(newCount - oldCount);
+    mCoords.resize(offset + (last - first) + grow);
+    float *c = mCoords.data();
+    std::copy(c + first, c + at, c + offset);
+    std::copy(c + at, c + last, c + offset + (at - first) + grow);
+    if(mHead / blockSize == block) mHeadCoords = mHeadCoords - first + offset;
+    mBlocks[block] = std::uint32_t(offset);
+    mGarbage += last - first;
+    moveTail();
+}
+
+void pathbuffer::moveTail() {
+    const size_t block = mBlocks.size() - 1;
+    const size_t first = mBlocks[block], last = blockEnd(block);
+    if(last == mCoords.size()) return;
+
+    const size_t offset = mCoords.size();
+    mCoords.resize(offset + last - first);
+    std::copy(mCoords.data() + first, mCoords.data() + last, mCoords.data() + offset);
+    if(mHead / blockSize == block) mHeadCoords = mHeadCoords - first + offset;
+    mBlocks[block] = std::uint32_t(offset);
+    mGarbage += last - first;
+}
+
+void pathbuffer::compact() {
+    /// The live coordinates are copied block by block, in order.
+    std::vector<float> coords;
+    coords.reserve(mCoords.size() - mGarbage);
+    for(size_t b = mHead / blockSize; b < mBlocks.size(); ++b) {
+        const size_t first = b == mHead / blockSize ? mHeadCoords : mBlocks[b];
+        coords.insert(coords.end(), mCoords.begin() + first, mCoords.begin() + blockEnd(b));
+    }
+    mCoords.swap(coords);
+    mVerbs.erase(mVerbs.begin(), mVerbs.begin() + mHead);
+    if(mStartIndex != npos) mStartIndex -= mHead;
+    mHead = mHeadCoords = mGarbage = 0;
+
+    /// Blocks start at other segments now, so they're rebuilt.
+    mBlocks.clear();
+    mBlockMoves.clear();
+    std::uint32_t c = 0;
+    size_t move = npos;
+    for(size_t i = 0; i < mVerbs.size(); ++i) {
+        if(i % blockSize == 0) {
+            mBlocks.push_back(c);
+            mBlockMoves.push_back(move);
+        }
+        c += coordCount(mVerbs[i]);
+        if(mVerbs[i] == Move) move = i;
+    }
+    resetBounds();
+}
+
+void pathbuffer::markDirty(size_t block) {
+    /// Blocks out of the tree only have pending segments, they're added on the next update anyway.
+    if(block < mLeaves && !mDirty[block]) {
+        mDirty[block] = true;
+        mDirtyBlocks.push_back(block);
+    }
+}
+
+void pathbuffer::markChanged(size_t p, bool wasMove) {
+    markDirty(p / blockSize);
+    /// Arcs bulge around their start point, so the arcs that start at the changed point change too,
+    ///  that's the next segment, or the arcs after the closes of the subpath if it's the subpath start.
+    const bool start = wasMove || mVerbs[p] == Move || p == mHead;
+    for(size_t i = p + 1; i < mVerbs.size() && (i == p + 1 || (start && mVerbs[i] != Move)); ++i) {
+        if(mVerbs[i] == Arc) markDirty(i / blockSize);
+    }
+}
+
+void pathbuffer::resetBounds() {
+    std::fill(mTree.begin(), mTree.end(), extent{});
+    std::fill(mDirty.begin(), mDirty.end(), false);
+    mDirtyBlocks.clear();
+    mPending = 0;
+}
+
+void pathbuffer::updateBounds() const {
+    growTree((mVerbs.size() + blockSize - 1) / blockSize);
+
+    for(const size_t block: mDirtyBlocks) {
+        mDirty[block] = false;
+        setLeaf(block, blockExtent(block));
+    }
+    mDirtyBlocks.clear();
+
+    /// Appended segments can only grow the extents of their blocks.
+    for(size_t p = std::max(mPending, mHead); p < mVerbs.size();) {
+        const size_t block = p / blockSize, last = std::min((block + 1) * blockSize, mVerbs.size());
+        extent e;
+        expandRange(e, p, last);
+        expandLeaf(block, e);
+        p = last;
+    }
+    mPending = mVerbs.size();
+}
+
+void pathbuffer::growTree(size_t blocks) const {
+    if(blocks <= mLeaves) return;
+
+    size_t leaves = std::max<size_t>(mLeaves, 1);
+    while(leaves < blocks) leaves *= 2;
+
+    std::vector<extent> tree(2 * leaves);
+    std::copy_n(mTree.begin() + mLeaves, mLeaves, tree.begin() + leaves);
+    for(size_t i = leaves; i-- > 1;) {
+        tree[i] = tree[2 * i];
+        tree[i].unite(tree[2 * i + 1]);
+    }
+
+    mTree = std::move(tree);
+    mLeaves = leaves;
+    mDirty.resize(leaves, false);
+}
+
+void pathbuffer::setLeaf(size_t block, const extent &e) const {
+    size_t i = mLeaves + block;
+    mTree[i] = e;
+    for(i /= 2; i >= 1; i /= 2) {
+        mTree[i] = mTree[2 * i];
+        mTree[i].unite(mTree[2 * i + 1]);
+    }
+}
+
+void pathbuffer::expandLeaf(size_t block, const extent &e) const {
+    for(size_t i = mLeaves + block; i >= 1; i /= 2) mTree[i].unite(e);
+}
+
+pathbuffer::extent pathbuffer::blockExtent(size_t block) const {
+    extent e;
+    const size_t first = std::max(block * blockSize, mHead);
+    const size_t last = std::min((block + 1) * blockSize, mVerbs.size());
+    if(first < last) expandRange(e, first, last);
+    return e;
+}
+
+void pathbuffer::expandRange(extent &e, size_t first, size_t last) const {
+    /// Arc parameters aren't points, so arcs are added by their curves.
+    const float *c = mCoords.data() + coordOf(first), *run = c;
+    for(size_t i = first; i < last; ++i) {
+        if(mVerbs[i] == Arc) {
+            simdTools::expand(e, run, (c - run) / 2);
+            expandArc(e, startOf(i), segment{Arc, c});
+            run = c + coordCount(Arc);
+        }
+        c += coordCount(mVerbs[i]);
+    }
+    simdTools::expand(e, run, (c - run) / 2);
+}
+
+apoint pathbuffer::startOf(size_t p) const {
+    /// Same as the geometry: the previous point, the last move after a close, or the first point.
+    if(p > mHead && mVerbs[p - 1] != Close) return physical(p - 1).to();
+    return subpathStart(p);
+}
+
+void pathbuffer::expandArc(extent &e, const apoint &from, const segment &s) {
+    simdTools::expand(e, s.coords + 4, 1);
+    /// The curves are inside the hull of their control points.
+    const auto curves = utils::arcTool::arcToCubic(from, s.to(), s.radius(), s.rotation(), s.largeArc(),
+                                                   s.sweepFlag());
+    for(const auto &curve: curves) {
+        const float points[] = {float(curve.c1.x()), float(curve.c1.y()), float(curve.c2.x()),
+                                float(curve.c2.y()), float(curve.to.x()), float(curve.to.y())};
+        simdTools::expand(e, points, 3);
+    }
+}
+} // namespace veqtor::shapes
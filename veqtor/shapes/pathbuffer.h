@@ -0,0 +1,323 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <variant>
+
+#include <QVariant>
+
+#include "apoint.h"
+#include "../utils/simdtools.h"
+
+namespace veqtor::shapes {
+namespace pd {
+    struct move  { };
+    struct line  { };
+    struct hr    { };
+    struct vr    { };
+    struct quad  { apoint control; };
+    struct tquad { apoint control; };
+    struct cubic { apoint c1, c2; };
+    struct scubic{ apoint control; };
+    struct arc   { QSizeF radius; qreal rotation; bool largeArc, sweepFlag; };
+    struct close { };
+}  // namespace pd
+
+/**
+ * @brief The pathdata struct
+ * @abstract A single path command, as it's written in the svg path data.
+ *  It's only used to exchange segments (e.g. with QML), paths are stored in `pathbuffer`.
+ */
+struct pathdata {
+    using path_data =
+        std::variant<pd::close, pd::move, pd::line, pd::vr, pd::hr, pd::arc,
+                     pd::quad, pd::tquad, pd::cubic, pd::scubic>;
+    using real_limit = std::numeric_limits<qreal>;
+    enum Type {Close, Move, Line, Vr, Hr, Arc, Quad, ShortQuad, Cubic, ShortCubic};
+
+    pathdata(const pd::close& data): relative{}, to{}, data{data} {}
+    pathdata(const apoint& point, const path_data& data, bool relative = false)
+        : relative{relative}, to{point}, data{data} {}
+    pathdata(char type, const apoint& point, const QVariantMap& vdata, bool relative = false)
+        : relative{relative}, to{point} {
+        switch(std::tolower(type)) {
+        case 'm': data = pd::move{}; break;
+        case 'l': data = pd::line{}; break;
+        case 'v': data = pd::vr{}; break;
+        case 'h': data = pd::hr{}; break;
+        case 'q': data = pd::quad{vdata["control"].toPointF()}; break;
+        case 't': data = pd::tquad{}; break;
+        case 'c': data = pd::cubic{vdata["control1"].toPointF(), vdata["control2"].toPointF()}; break;
+        case 's': data = pd::scubic{vdata["control"].toPointF()}; break;
+        case 'a': data = pd::arc{vdata["radius"].toSizeF(), vdata["rotation"].toDouble(),
+                                 vdata["largeArc"].toBool(), vdata["sweepFlag"].toBool()}; break;
+        case 'z': default: data = pd::close{};
+        }
+    }
+    pathdata(const QVariantMap &map)
+        : pathdata(map["type"].toChar().toLatin1(), map["to"].toPointF(),
+                   map["data"].toMap(), map["relative"].toBool()) {}
+
+    Type type() const { return static_cast<Type>(data.index()); }
+    char typeChar() const { return "zmlvhaqtcs"[data.index()]; }
+
+    bool isVr() const { return data.index() == Vr; }
+    bool isHr() const { return data.index() == Hr; }
+    bool isMove() const { return data.index() == Move; }
+    bool isLine() const { return data.index() == Line; }
+    bool isArc()  const { return data.index() == Arc; }
+    bool isQuad() const { return data.index() == Quad; }
+    bool isCubic() const { return data.index() == Cubic; }
+    bool isShortQuad() const { return data.index() == ShortQuad; }
+    bool isShortCubic() const { return data.index() == ShortCubic; }
+    bool isClose() const { return data.index() == Close; }
+
+    pd::scubic scubic() const { return std::get<pd::scubic>(data); }
+    pd::scubic &scubic() { return std::get<pd::scubic>(data); }
+    pd::cubic cubic() const { return std::get<pd::cubic>(data); }
+    pd::cubic &cubic() { return std::get<pd::cubic>(data); }
+    pd::tquad tquad() const { return std::get<pd::tquad>(data); }
+    pd::tquad &tquad() { return std::get<pd::tquad>(data); }
+    pd::quad quad() const { return std::get<pd::quad>(data); }
+    pd::quad &quad() { return std::get<pd::quad>(data); }
+    pd::arc arc() const { return std::get<pd::arc>(data); }
+    pd::arc &arc() { return std::get<pd::arc>(data); }
+
+    /** @return The segment in the same form that the `QVariantMap` constructor accepts. */
+    QVariantMap map() const {
+        QVariantMap value{{"relative", relative},{"to", to}};
+        value["type"] = QChar(typeChar());
+        if(isCubic()) { value["data"] = QVariantMap{{"control1", cubic().c1}, {"control2", cubic().c2}}; }
+        else if(isQuad()) { value["data"] = QVariantMap{{"control", quad().control}}; }
+        else if(isShortCubic()) { value["data"] = QVariantMap{{"control", scubic().control}}; }
+        else if(isArc()) {
+            value["data"] = QVariantMap{
+                {"radius",    arc().radius   },
+                {"rotation",  arc().rotation },
+                {"sweepFlag", arc().sweepFlag},
+                {"largeArc",  arc().largeArc },
+            };
+        }
+        return value;
+    }
+
+    bool relative;
+    apoint to;
+    path_data data;
+};
+
+/**
+ * @brief The pathbuffer class
+ * @abstract Compact storage of path segments, a byte per segment for the verb and a packed float array for
+ *  the coordinates (2 for move and line, 4 for quad, 6 for cubic and arc, none for close).
+ *  Relative coordinates, horizontal and vertical lines and the shorthand curves (`s`, `t`) are resolved to
+ *  absolute segments when they are inserted, so the stored segments don't depend on each other.
+ *  The last two coordinates of each segment (except close) are its end point.
+ *  Arcs keep their svg parameters: rx, ry, x-axis-rotation, flags (bit 0 large-arc, bit 1 sweep), x, y.
+ *
+ *  Segments are grouped in blocks of `blockSize`, each block keeps the coordinate offset of its first segment
+ *  (so random access walks at most a block), the last move before it (so the subpath start of a segment is found
+ *  in its block) and its extent in a min/max tree, which keeps `bounds` exact without rescanning the path.
+ *  The coordinates of a block are packed, but a block that grows in `set` is moved to the end of the array,
+ *  so an edit never shifts the other blocks:
+ * @list
+ * @li appended segments only grow their block, they're added on the next `bounds` call,
+ * @li edited and removed segments mark their block (and the blocks of the arcs that start at them), it's
+ *      recomputed once on the next `bounds` call,
+ * @li removing the first segment only moves the head, the removed segments and the holes of the moved blocks
+ *      are compacted once they're as many as the live ones, so shifts are amortized O(1).
+ * @endlist
+ */
+class pathbuffer {
+public:
+    enum Verb : std::uint8_t { Move, Line, Quad, Cubic, Arc, Close };
+
+    /** @brief The segment struct, a view of a stored segment. */
+    struct segment {
+        Verb verb;
+        const float *coords;
+
+        apoint point(int index) const { return apoint{coords[2 * index], coords[2 * index + 1]}; }
+        /** @return end point of the segment, not valid for close. */
+        apoint to() const { return point(coordCount(verb) / 2 - 1); }
+        QSizeF radius() const { return QSizeF{coords[0], coords[1]}; }
+        qreal rotation() const { return coords[2]; }
+        bool largeArc() const { return int(coords[3]) & 1; }
+        bool sweepFlag() const { return int(coords[3]) & 2; }
+    };
+
+    /** @brief The const_iterator class, iterates over stored segments in order. */
+    class const_iterator {
+    public:
+        const_iterator(const pathbuffer *buffer, size_t p, const float *coords)
+            : mBuffer(buffer), mIndex(p), mCoords(coords) {}
+
+        segment operator *() const { return {mBuffer->mVerbs[mIndex], mCoords}; }
+        const_iterator &operator ++() {
+            mCoords += coordCount(mBuffer->mVerbs[mIndex++]);
+            /// The next block may be stored anywhere in the array.
+            if(mIndex % blockSize == 0 && mIndex < mBuffer->mVerbs.size()) {
+                mCoords = mBuffer->mCoords.data() + mBuffer->mBlocks[mIndex / blockSize];
+            }
+            return *this;
+        }
+        bool operator ==(const const_iterator &other) const { return mIndex == other.mIndex; }
+        bool operator !=(const const_iterator &other) const { return mIndex != other.mIndex; }
+
+    private:
+        const pathbuffer *mBuffer;
+        size_t mIndex;
+        const float *mCoords;
+    };
+
+    /** @return number of coordinates used by the given verb. */
+    static constexpr int coordCount(Verb verb) {
+        return verb == Move || verb == Line ? 2 : verb == Quad ? 4 : verb == Cubic || verb == Arc ? 6 : 0;
+    }
+
+    pathbuffer() = default;
+    /** @brief pathbuffer, the segments are pushed in order, e.g. `{{p, pd::move{}}, {q, pd::line{}}, pd::close{}}`. */
+    pathbuffer(std::initializer_list<pathdata> segments);
+
+    void moveTo(const apoint &to, bool relative = false);
+    void lineTo(const apoint &to, bool relative = false);
+    void hTo(qreal x, bool relative = false);
+    void vTo(qreal y, bool relative = false);
+    void quadTo(const apoint &control, const apoint &to, bool relative = false);
+    void shortQuadTo(const apoint &to, bool relative = false);
+    void cubicTo(const apoint &c1, const apoint &c2, const apoint &to, bool relative = false);
+    void shortCubicTo(const apoint &c2, const apoint &to, bool relative = false);
+    void arcTo(const apoint &to, const QSizeF &radius, qreal rotation, bool largeArc, bool sweepFlag,
+               bool relative = false);
+    void close();
+
+    /** @brief push, appends a segment of any type, it's resolved like the svg path data. */
+    void push(const pathdata &data);
+
+    /**
+     * @brief set
+     * @abstract Replaces the segment at @a index, relative coordinates are resolved from the previous segment.
+     * @return false if the index is out of range.
+     */
+    bool set(size_t index, const pathdata &data);
+    /** @brief setPoint, moves the end point of the segment at @a index (close segments are unchanged). */
+    bool setPoint(size_t index, const apoint &to);
+
+    /** @return The segment at @a index as absolute pathdata. */
+    pathdata at(size_t index) const;
+    segment operator [](size_t index) const { return physical(mHead + index); }
+
+    void pop();
+    void popFront();
+    void clear();
+    void reserve(size_t segments, size_t coords) { mVerbs.reserve(segments); mCoords.reserve(coords); }
+    /** @brief squeeze, releases the reserved memory if more than a half of it is unused. */
+    void squeeze();
+
+    /**
+     * @brief transform
+     * @abstract Maps all points and controls. Arc radii and rotations are only exact for similarity transforms.
+     */
+    void transform(const QTransform &transform);
+
+    /**
+     * @brief bounds
+     * @abstract Bounding box of the points and control points, so it contains the curves, arcs are added
+     *  by the control points of their cubic curves.
+     *  It only updates the blocks that have changed since the last call.
+     * @return null rect if the buffer has no point.
+     */
+    QRectF bounds() const;
+
+    /// getters
+    const_iterator begin() const { return {this, mHead, mCoords.data() + mHeadCoords}; }
+    const_iterator end() const { return {this, mVerbs.size(), mCoords.data() + mCoords.size()}; }
+    segment front() const { return {mVerbs[mHead], mCoords.data() + mHeadCoords}; }
+    segment back() const { return {mVerbs.back(), mCoords.data() + mCoords.size() - coordCount(mVerbs.back())}; }
+    bool empty() const { return mVerbs.size() == mHead; }
+    size_t size() const { return mVerbs.size() - mHead; }
+    /** @return the current point, where the next segment starts. */
+    apoint current() const { return mCurrent; }
+    /** @return heap memory used by the buffer in bytes. */
+    size_t bytes() const {
+        return mVerbs.capacity() * sizeof(Verb) + mCoords.capacity() * sizeof(float) +
+               mBlocks.capacity() * sizeof(std::uint32_t) + mBlockMoves.capacity() * sizeof(size_t) +
+               mTree.capacity() * sizeof(extent);
+    }
+
+    /// Number of segments in a bounds block.
+    static constexpr size_t blockSize = 64;
+
+private:
+    using extent = utils::simdTools::extent;
+    static constexpr size_t npos = size_t(-1);
+
+    void push(Verb verb);
+    void push(const apoint &p) { mCoords.push_back(float(p.x())); mCoords.push_back(float(p.y())); }
+    apoint absolute(const apoint &p, bool relative) const { return relative ? apoint(p + mCurrent) : p; }
+    /** @return reflection of the last control point of the given verb, or the current point. */
+    apoint reflection(Verb verb) const;
+    /** @return coordinate offset of the segment at the physical index @a p (removed head segments included). */
+    size_t coordOf(size_t p) const;
+    segment physical(size_t p) const { return {mVerbs[p], mCoords.data() + coordOf(p)}; }
+    /** @brief updateEnds, updates the subpath start and the current points from `mStartIndex` and the last segment. */
+    void updateEnds();
+    /** @return Physical index of the last move before the physical index @a p (a removed one too), or `npos`. */
+    size_t lastMove(size_t p) const;
+    /** @return Physical index of the last move before @a p that is not removed, or `npos`. */
+    size_t liveMove(size_t p) const { const size_t m = lastMove(p); return m != npos && m >= mHead ? m : npos; }
+    /** @return The point where the subpath of the physical index @a p starts, the last move or the first point. */
+    apoint subpathStart(size_t p) const;
+    /** @return The coordinate offset after the last segment of the block. */
+    size_t blockEnd(size_t block) const;
+    /**
+     * @brief resizeSegment
+     * @abstract Changes the room of the segment at the physical index @a p from @a oldCount to @a newCount
+     *  coordinates, the new ones are not initialized. The last block is resized in place, other blocks shrink
+     *  in place and move to the end of the array to grow (the last block is moved after them).
+     */
+    void resizeSegment(size_t p, int oldCount, int newCount);
+    /** @brief moveTail, moves the coordinates of the last block to the end of the array, if they're not there. */
+    void moveTail();
+    /** @brief compact, erases the removed head segments and the holes, and rebuilds the blocks. */
+    void compact();
+
+    void markDirty(size_t block);
+    /** @brief markChanged, marks the block of the physical index @a p and the blocks of the arcs that start there. */
+    void markChanged(size_t p, bool wasMove = false);
+    void resetBounds();
+    void updateBounds() const;
+    void growTree(size_t blocks) const;
+    void setLeaf(size_t block, const extent &e) const;
+    void expandLeaf(size_t block, const extent &e) const;
+    extent blockExtent(size_t block) const;
+    void expandRange(extent &e, size_t first, size_t last) const;
+    /** @return The point where the segment at the physical index @a p starts. */
+    apoint startOf(size_t p) const;
+    static void expandArc(extent &e, const apoint &from, const segment &s);
+
+    std::vector<Verb> mVerbs;
+    std::vector<float> mCoords;
+    /// Removed segments (and their coordinates) at the beginning of the vectors.
+    size_t mHead = 0, mHeadCoords = 0;
+    /// Coordinate offset of the first segment of each block, the last block always ends the array.
+    std::vector<std::uint32_t> mBlocks;
+    /// Physical index of the last move before each block, `npos` if there is no move.
+    std::vector<size_t> mBlockMoves;
+    /// Coordinates of no segment: the removed head segments and the holes of the moved or shrunk blocks.
+    size_t mGarbage = 0;
+    /// Physical index of the move that starts the last subpath, `npos` if there is no move.
+    size_t mStartIndex = npos;
+    apoint mCurrent, mStart;
+
+    /// Min/max tree of the block extents, leaves are at [mLeaves, 2 * mLeaves) and the root at 1.
+    mutable std::vector<extent> mTree;
+    mutable size_t mLeaves = 0;
+    mutable std::vector<bool> mDirty;
+    mutable std::vector<size_t> mDirtyBlocks;
+    /// Physical index of the first segment that is not added to the tree.
+    mutable size_t mPending = 0;
+};
+} // namespace veqtor::shapes
@@ -17,7 +17,7 @@ public:
         : rect(QRectF(topLeft, bottomRight), pen) {}
 
     operator path() const {
-        path ps(mPen);
+        path ps(pen());
 
         const auto &rads = mCornerRadius;
         const apoint bb[] = {
@@ -46,8 +46,7 @@ public:
             {bb[0], pd::line{}},
             pd::close{},
         });
-        ps.setTransform(transformer());
-        ps.applyTransform();
+        ps.applyTransform(transformer());
 
         return ps;
     }
@@ -62,27 +61,30 @@ public:
     ShapeType type() const override { return ShapeType::Rect; }
     bool isNull() const override { return QRectF::isNull(); }
 
+    /**
+     * @brief contains
+     * @abstract The point is tested against the signed distance of the (rounded) rectangle,
+     *  so the cost is constant. Each quadrant uses the radius of its own corner.
+     * @param point
+     * @return PointState::Edge if the point is within the stroke (or `edgeTolerance`) of the outline,
+     *  PointState::Inside if the rectangle is filled and the point is inside of it, otherwise PointState::None.
+     */
     PointState contains(const apoint &point) const override {
-        apoint rp = invertTransformer().map(point);
-        if(radius() == 0.0f) {
-            const float off = 2.0f; ///> 2x offset for edges area.
-            bool inside = adjusted(-off, -off, off, off).contains(rp) && mPen.mFill;
-            bool overEdges = rp.isBetween(topLeft(), topRight()) ||
-                             rp.isBetween(topRight(), bottomRight()) ||
-                             rp.isBetween(bottomRight(), bottomLeft()) ||
-                             rp.isBetween(bottomLeft(), topLeft());
+        const apoint rp = invertTransformer().map(point);
+        const QRectF r = normalized();
+        const qreal hw = r.width() / 2, hh = r.height() / 2;
+        const qreal dx = rp.x() - r.center().x(), dy = rp.y() - r.center().y();
 
-            return overEdges ? PointState::Edge :
-                     inside  ? PointState::Inside :
-                               PointState::None;
-        } else {
-            /**
-             * FIXME: detect if rounded rect contains point.
-             * https://stackoverflow.com/questions/401847/circle-rectangle-collision-detection-intersection
-             */
-            qErrnoWarning("method rect::contains() can't handle rounded rectangles.");
-            return PointState::None;
-        }
+        /// Corners are indexed clockwise from the top left (see `operator path`).
+        const int corner = dy < 0 ? (dx < 0 ? 0 : 1) : (dx < 0 ? 3 : 2);
+        const qreal rad = std::clamp<qreal>(mCornerRadius[corner], 0.0, std::min(hw, hh));
+        const qreal qx = std::abs(dx) - hw + rad, qy = std::abs(dy) - hh + rad;
+        const qreal distance = std::hypot(std::max(qx, 0.0), std::max(qy, 0.0)) +
+                               std::min(std::max(qx, qy), 0.0) - rad;
+
+        return std::abs(distance) <= edgeRadius() ? PointState::Edge :
+               distance < 0 && mPen->filled()      ? PointState::Inside :
+                                                    PointState::None;
     }
 
     /// setters
@@ -111,6 +113,7 @@ public:
     void setCornerRadius(const std::array<float, 4>& newCornerRadius) {
         mCornerRadius = newCornerRadius;
     }
+    void setCornerRadius(float radius) { mCornerRadius.fill(radius); }
 
     /// getters
     apoint center() const override { return QRectF::center(); }
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include "series.h"
+#include "../utils/simdtools.h"
+
+namespace veqtor::shapes {
+series::series(size_t capacity, const core::nanoPen &pen)
+    : shape(pen), mPoints(2 * capacity), mCapacity(capacity) {}
+
+void series::append(float x, float y) {
+    if(mCapacity == 0) return;
+
+    const size_t tail = (mHead + mSize) % mCapacity;
+    mPoints[2 * tail] = x;
+    mPoints[2 * tail + 1] = y;
+
+    if(mSize < mCapacity) ++mSize;
+    else mHead = (mHead + 1) % mCapacity;
+}
+
+void series::append(const float *xy, size_t count) {
+    if(mCapacity == 0 || count == 0) return;
+    /// Only the newest points fit into the buffer.
+    if(count > mCapacity) {
+        xy += 2 * (count - mCapacity);
+        count = mCapacity;
+    }
+
+    const size_t tail = (mHead + mSize) % mCapacity;
+    const size_t first = std::min(count, mCapacity - tail);
+    std::copy_n(xy, 2 * first, mPoints.data() + 2 * tail);
+    std::copy_n(xy + 2 * first, 2 * (count - first), mPoints.data());
+
+    const size_t overflow = mSize + count > mCapacity ? mSize + count - mCapacity : 0;
+    mSize += count - overflow;
+    mHead = (mHead + overflow) % mCapacity;
+}
+
+void series::append(const QPointF *points, size_t count) {
+    if(mCapacity == 0 || count == 0) return;
+    if(count > mCapacity) {
+        points += count - mCapacity;
+        count = mCapacity;
+    }
+
+    size_t tail = (mHead + mSize) % mCapacity;
+    for(size_t i = 0; i < count; ++i) {
+        mPoints[2 * tail] = static_cast<float>(points[i].x());
+        mPoints[2 * tail + 1] = static_cast<float>(points[i].y());
+        if(++tail == mCapacity) tail = 0;
+    }
+
+    const size_t overflow = mSize + count > mCapacity ? mSize + count - mCapacity : 0;
+    mSize += count - overflow;
+    mHead = (mHead + overflow) % mCapacity;
+}
+
+size_t series::shift(size_t count) {
+    count = std::min(count, mSize);
+    if(count) mHead = (mHead + count) % mCapacity;
+    mSize -= count;
+    return count;
+}
+
+apoint series::at(size_t index) const {
+    if(index >= mSize) return apoint();
+    const size_t i = (mHead + index) % mCapacity;
+    return apoint{mPoints[2 * i], mPoints[2 * i + 1]};
+}
+
+QTransform series::mapping() const {
+    if(mWindow.isEmpty() || mViewport.isEmpty()) return QTransform();
+
+    const qreal sx = mViewport.width() / mWindow.width();
+    const qreal sy = mViewport.height() / mWindow.height();
+    /// The window's y axis grows upward.
+    return QTransform(sx, 0, 0, -sy,
+                      mViewport.left() - mWindow.left() * sx,
+                      mViewport.bottom() + mWindow.top() * sy);
+}
+
+void series::setCapacity(size_t capacity) {
+    if(capacity == mCapacity) return;
+
+    std::vector<float> points(2 * capacity);
+    const size_t count = std::min(mSize, capacity);
+    for(size_t i = 0; i < count; ++i) {
+        const apoint p = at(mSize - count + i);
+        points[2 * i] = static_cast<float>(p.x());
+        points[2 * i + 1] = static_cast<float>(p.y());
+    }
+
+    mPoints.swap(points);
+    mCapacity = capacity;
+    mHead = 0;
+    mSize = count;
+}
+
+PointState series::contains(const apoint &point) const {
+    if(mSize == 0) return PointState::None;
+
+    const QTransform m = mapping();
+    const apoint p = invertTransformer().map(point);
+    const qreal radius = std::max<qreal>(mPen->mWidth / 2.0, 0.5);
+    const qreal radius2 = radius * radius;
+
+    bool hit = false;
+    bool first = true;
+    qreal ax = 0, ay = 0;
+    forEachSpan([&](const float *xy, size_t count) {
+        for(size_t i = 0; i < count && !hit; ++i) {
+            const qreal bx = m.m11() * xy[2 * i] + m.dx(), by = m.m22() * xy[2 * i + 1] + m.dy();
+            if(!first) {
+                const qreal dx = bx - ax, dy = by - ay, length2 = dx * dx + dy * dy;
+                const qreal t = length2 > 0 ? std::clamp(((p.x() - ax) * dx + (p.y() - ay) * dy) / length2, 0.0, 1.0) : 0.0;
+                const qreal ex = ax + t * dx - p.x(), ey = ay + t * dy - p.y();
+                hit = ex * ex + ey * ey <= radius2;
+            }
+            ax = bx; ay = by;
+            first = false;
+        }
+    });
+    return hit ? PointState::Edge : PointState::None;
+}
+
+const QRectF &series::updateBoundingBox() {
+    if(mSize == 0) {
+        mBoundingBox = QRectF();
+        return mBoundingBox;
+    }
+
+    utils::simdTools::extent e;
+    forEachSpan([&e](const float *xy, size_t count) { utils::simdTools::expand(e, xy, count); });
+
+    mBoundingBox = mapping().mapRect(e.rect());
+    return mBoundingBox;
+}
+}  // namespace veqtor::shapes
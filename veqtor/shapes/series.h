@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QTransform>
+
+#include <vector>
+#include <algorithm>
+
+#include "shape.h"
+
+namespace veqtor::shapes {
+/**
+ * @brief The series class
+ * @abstract A polyline for real-time plotting, its points are stored in a ring buffer of packed floats (x, y).
+ *  Appending and shifting points are O(1) (bulk appends are two block copies), and when the buffer is full
+ *  the oldest points are overwritten.
+ *  Points are in data coordinates, they are mapped from the `window` (y grows upward) to the `viewport` on painting,
+ *  so changing the visible range does not touch the points.
+ */
+class series : public shape {
+public:
+    explicit series(size_t capacity = 1024, const core::nanoPen &pen = core::nanoPen());
+
+    /// modifiers
+    void append(float x, float y);
+    /**
+     * @brief append
+     * @param xy, Packed x, y pairs.
+     * @param count, Number of points (half of the number of floats).
+     */
+    void append(const float *xy, size_t count);
+    void append(const QPointF *points, size_t count);
+    /**
+     * @brief shift
+     * @abstract Removes points from the front of the series.
+     * @return Number of removed points.
+     */
+    size_t shift(size_t count = 1);
+    void clear() { mHead = mSize = 0; }
+
+    /// getters
+    size_t size() const { return mSize; }
+    size_t capacity() const { return mCapacity; }
+    bool empty() const { return mSize == 0; }
+    apoint at(size_t index) const;
+    const QRectF &window() const { return mWindow; }
+    const QRectF &viewport() const { return mViewport; }
+
+    /**
+     * @brief mapping
+     * @return The transform from the window to the viewport. It's the identity if any of them is empty.
+     */
+    QTransform mapping() const;
+
+    /**
+     * @brief forEachSpan
+     * @abstract Calls @a callback with the contiguous blocks of the buffer (at most two), in the series order.
+     * @param callback, `void(const float *xy, size_t count)`
+     */
+    template<typename Callback>
+    void forEachSpan(Callback &&callback) const {
+        const size_t first = std::min(mSize, mCapacity - mHead);
+        if(first) callback(mPoints.data() + 2 * mHead, first);
+        if(mSize > first) callback(mPoints.data(), mSize - first);
+    }
+
+    /// setters
+    /**
+     * @brief setCapacity
+     * @abstract Re-allocates the buffer, the newest points are kept.
+     */
+    void setCapacity(size_t capacity);
+    void setWindow(const QRectF &window) { mWindow = window; }
+    void setViewport(const QRectF &viewport) { mViewport = viewport; }
+
+    PointState contains(const apoint &point) const override;
+    ShapeType type() const override { return ShapeType::Series; }
+    bool isNull() const override { return mSize == 0; }
+
+    /**
+     * @brief updateBoundingBox
+     * @abstract Recomputes the bounding box of the mapped points, it's O(n) so it should be called once per frame.
+     */
+    const QRectF &updateBoundingBox() override;
+
+private:
+    std::vector<float> mPoints;
+    size_t mCapacity;
+    size_t mHead = 0;
+    size_t mSize = 0;
+
+    QRectF mWindow;
+    QRectF mViewport;
+};
+}  // namespace veqtor::shapes
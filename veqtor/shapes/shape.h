@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <array>
 
@@ -20,6 +21,7 @@ enum ShapeType {
     Polygon,
     Text,
     TextPath,
+    Series,
 };
 
 class shape {
@@ -28,7 +30,7 @@ public:
 
     shape() = default;
     shape(const QRectF &rect, const core::nanoPen &pen = core::nanoPen())
-        : mBoundingBox(rect), mPen(pen), mTransform{nullptr} {}
+        : mBoundingBox(rect), mPen(core::penTable::intern(pen)), mTransform{nullptr} {}
     shape(const apoint p1, const apoint p2, const core::nanoPen &pen = core::nanoPen())
         : shape(QRectF(p1, p2), pen) {}
     shape(const QLineF line, const core::nanoPen &pen = core::nanoPen())
@@ -67,8 +69,9 @@ public:
 
     /// getters
     const QRectF &boundingBox() const { return mBoundingBox; }
-    const core::nanoPen &pen() const { return mPen; }
-    core::nanoPen &pen() { return mPen; }
+    const core::nanoPen &pen() const { return *mPen; }
+    /// The pen is shared with the other shapes of the same style, so it's only changed by `setPen`.
+    const core::penTable::handle &sharedPen() const { return mPen; }
     QTransform invertTransformer() const { return transformer().inverted(); }
     QTransform transformer() const {
         return mTransform ? *mTransform : QTransform();
@@ -84,10 +87,20 @@ public:
     virtual const QRectF &updateBoundingBox() { return mBoundingBox; }
     virtual void setBoundingBox(const QRectF &boundingBox) { mBoundingBox = boundingBox; }
 
+    /// Minimum distance (in shape units) to the outline that counts as an edge hit.
+    static constexpr qreal edgeTolerance = 0.5;
+
     /// setters
-    void setTransform(const QTransform &transform) { *mTransform = transform; }
     void setTransform(QTransform *transform) { mTransform = transform; }
-    void setPen(const core::nanoPen &newPen) { mPen = newPen; }
+    void setPen(const core::nanoPen &newPen) { mPen = core::penTable::intern(newPen); }
+    void setPen(const core::penTable::handle &newPen) { mPen = newPen; }
+    /** @brief editPen, Applies @a edit to a copy of the pen and interns the result. */
+    template<class Edit>
+    void editPen(Edit &&edit) {
+        core::nanoPen pen = *mPen;
+        edit(pen);
+        setPen(pen);
+    }
 
     /// static members
     /**
@@ -121,8 +134,13 @@ public:
     }
 
 protected:
+    /** @return The distance from the outline that is covered by the stroke, at least `edgeTolerance`. */
+    qreal edgeRadius() const {
+        return std::max<qreal>(mPen->stroke() ? mPen->mWidth / 2.0 : 0.0, edgeTolerance);
+    }
+
     QRectF mBoundingBox;
-    core::nanoPen mPen;
+    core::penTable::handle mPen = core::penTable::defaultPen();
     QTransform *mTransform;
 };
 }  // namespace veqtor::shape
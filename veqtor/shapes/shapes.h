@@ -1,8 +1,12 @@
 #include "shape.h"
 #include "line.h"
 #include "path.h"
+#include "pathbuffer.h"
 #include "ellipse.h"
 #include "rectangle.h"
+#include "series.h"
+#include "geometry.h"
+#include "geometrycache.h"
 
 /**
  *  TODO: add polygon type.
@@ -16,6 +20,10 @@ namespace veqtor::shapes {
 class shape;
 class line;
 class path;
+class pathbuffer;
 class ellipse;
 class rect;
+class series;
+class geometry;
+class geometryCache;
 }
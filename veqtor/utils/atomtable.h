@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+
+#include <deque>
+
+namespace veqtor::utils {
+/**
+ * @brief The atomTable class
+ * @abstract Interns names (e.g. attribute names) of a document.
+ *  Each distinct name is stored once and referenced by a small integer, the `atom`,
+ *  and all elements share the same implicitly-shared QString instance of the name.
+ *  Lookups are done with QStringView, so no temporary string is allocated for known names.
+ */
+class atomTable {
+public:
+    using atom = int;
+
+    /**
+     * @brief intern
+     * @param name
+     * @return atom of the given name, the name is inserted if it doesn't exist.
+     */
+    atom intern(QStringView name) {
+        auto it = mIndex.constFind(name);
+        if(it != mIndex.cend()) return it.value();
+
+        /// `std::deque` never relocates its items, and QString data is not moved by the container,
+        ///  so the QStringView keys remain valid.
+        mNames.push_back(name.toString());
+        const atom a = static_cast<atom>(mNames.size() - 1);
+        mIndex.insert(QStringView(mNames.back()), a);
+        return a;
+    }
+
+    /**
+     * @brief find
+     * @param name
+     * @return atom of the given name, or -1 if the name is not interned.
+     */
+    atom find(QStringView name) const { return mIndex.value(name, -1); }
+
+    /** @return interned string of the given atom. */
+    const QString &name(atom a) const { return mNames[a]; }
+    /** @return interned copy of the given name. */
+    const QString &string(QStringView name) { return mNames[intern(name)]; }
+
+    int size() const { return static_cast<int>(mNames.size()); }
+
+private:
+    std::deque<QString> mNames;
+    QHash<QStringView, atom> mIndex;
+};
+} // namespace veqtor::utils
@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "attributelist.h"
+
+namespace veqtor::utils {
+attributeList::attributeList(std::initializer_list<std::pair<QString, QString>> attrs)
+    : mAtoms(std::make_shared<atomTable>()) {
+    mEntries.reserve(attrs.size());
+    for(const auto &attr: attrs) insert(attr.first, attr.second);
+}
+
+QString attributeList::value(const QString &name, const QString &fallback) const {
+    const int i = indexOf(name);
+    return i < 0 ? fallback : mEntries[i].value;
+}
+
+void attributeList::insert(QStringView name, const QString &value) {
+    const int i = indexOf(name);
+    if(i < 0) append(name, value);
+    else mEntries[i].value = value;
+}
+
+void attributeList::append(QStringView name, const QString &value) {
+    if(!mAtoms) mAtoms = std::make_shared<atomTable>();
+    mEntries.push_back({mAtoms->intern(name), value});
+}
+
+void attributeList::remove(const QString &name) {
+    const int i = indexOf(name);
+    if(i >= 0) mEntries.erase(mEntries.begin() + i);
+}
+
+void attributeList::remove(const QStringList &names) {
+    if(!mAtoms || mEntries.empty()) return;
+    /// Names that are not interned can't be in the list.
+    std::vector<atom> atoms;
+    for(const auto &name: names) {
+        const atom a = mAtoms->find(name);
+        if(a >= 0) atoms.push_back(a);
+    }
+    if(atoms.empty()) return;
+    mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(), [&](const entry &e) {
+        return std::find(atoms.cbegin(), atoms.cend(), e.name) != atoms.cend();
+    }), mEntries.end());
+}
+
+int attributeList::indexOf(QStringView name) const {
+    if(!mAtoms) return -1;
+    const atom a = mAtoms->find(name);
+    if(a < 0) return -1;
+    for(int i = 0; i < size(); ++i) {
+        if(mEntries[i].name == a) return i;
+    }
+    return -1;
+}
+} // namespace veqtor::utils
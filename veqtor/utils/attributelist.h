@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "atomtable.h"
+
+namespace veqtor::utils {
+/**
+ * @brief The attributeList class
+ * @abstract The attributes of an element, as a small flat array of (atom, value) pairs.
+ *  The names are interned in an atom table that is shared by all of the elements of a document,
+ *  so a name is stored once per document instead of once per element. Elements have a few attributes,
+ *  so they are searched linearly.
+ */
+class attributeList {
+public:
+    using atom = atomTable::atom;
+
+    struct entry {
+        atom name;
+        QString value;
+    };
+
+    attributeList() = default;
+    explicit attributeList(std::shared_ptr<atomTable> atoms): mAtoms(std::move(atoms)) {}
+    /** @brief attributeList, A list with its own atom table, e.g. `{{"d", data}}`. */
+    attributeList(std::initializer_list<std::pair<QString, QString>> attrs);
+
+    /// getters
+    QString value(const QString &name, const QString &fallback = QString()) const;
+    QString operator[](const QString &name) const { return value(name); }
+    bool contains(const QString &name) const { return indexOf(name) >= 0; }
+
+    int size() const { return static_cast<int>(mEntries.size()); }
+    bool empty() const { return mEntries.empty(); }
+    /** @return The name of the attribute at @a index. */
+    const QString &name(int index) const { return mAtoms->name(mEntries[index].name); }
+    /** @return The value of the attribute at @a index. */
+    const QString &valueAt(int index) const { return mEntries[index].value; }
+
+    std::vector<entry>::const_iterator begin() const { return mEntries.cbegin(); }
+    std::vector<entry>::const_iterator end() const { return mEntries.cend(); }
+
+    /** @return The table that the names are interned in. */
+    const std::shared_ptr<atomTable> &atoms() const { return mAtoms; }
+
+    /// setters
+    /** @brief insert, Sets the value of an attribute, it's appended if it doesn't exist. */
+    void insert(QStringView name, const QString &value);
+    /**
+     * @brief append
+     * @abstract Appends an attribute without looking for an existing one, e.g. for the unique attributes of
+     *  a parsed element.
+     */
+    void append(QStringView name, const QString &value);
+    void remove(const QString &name);
+    /** @brief remove, Removes all of the given attributes in a single pass. */
+    void remove(const QStringList &names);
+    void reserve(int size) { mEntries.reserve(size); }
+
+private:
+    /** @return The index of an attribute, or -1. */
+    int indexOf(QStringView name) const;
+
+    std::shared_ptr<atomTable> mAtoms;
+    std::vector<entry> mEntries;
+};
+} // namespace veqtor::utils
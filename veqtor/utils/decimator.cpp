@@ -0,0 +1,52 @@
+#include <cmath>
+#include <algorithm>
+
+#include "decimator.h"
+
+namespace veqtor::utils {
+void decimator::moveTo(float x, float y) {
+    flush();
+    mOut.moveTo(x, y);
+    /// The move point starts the next run, but it's already emitted.
+    mFirst = mMin = mMax = mLast = vertex{x, y, ++mIndex};
+    mColumn = columnOf(x);
+    mRunning = true;
+}
+
+void decimator::lineTo(float x, float y) {
+    const vertex v{x, y, ++mIndex};
+    const long long column = columnOf(x);
+
+    if(!mRunning || column != mColumn) {
+        flush();
+        mFirst = mMin = mMax = v;
+        mColumn = column;
+        mRunning = true;
+        mOut.lineTo(x, y);
+    } else {
+        if(y < mMin.y) mMin = v;
+        if(y > mMax.y) mMax = v;
+    }
+    mLast = v;
+}
+
+long long decimator::columnOf(float x) const {
+    return static_cast<long long>(std::floor(mScale * x + mOffset));
+}
+
+void decimator::flush() {
+    if(!mRunning) return;
+    mRunning = false;
+
+    /// The first point of the run is emitted when the run starts.
+    vertex rest[3] = {mMin, mMax, mLast};
+    std::sort(std::begin(rest), std::end(rest), [](const vertex &a, const vertex &b) { return a.index < b.index; });
+
+    size_t last = mFirst.index;
+    for(const vertex &v: rest) {
+        if(v.index == last) continue;
+        mOut.lineTo(v.x, v.y);
+        last = v.index;
+    }
+}
+} // namespace veqtor::utils
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../shapes/geometry.h"
+
+namespace veqtor::utils {
+/**
+ * @brief The decimator class
+ * @abstract Per-pixel min/max envelope of polylines.
+ *  Consecutive points that fall into the same device pixel column are reduced to the first, lowest, highest
+ *  and last of them (in their original order), so the drawn polyline covers the same pixels as the full one,
+ *  while at most four points per column are kept.
+ *  The device column of a point is `floor(scale * x + offset)`.
+ */
+class decimator {
+public:
+    decimator(shapes::geometry &out, qreal scale, qreal offset)
+        : mOut(out), mScale(scale), mOffset(offset) {}
+    ~decimator() { flush(); }
+
+    decimator(const decimator&) = delete;
+    decimator &operator = (const decimator&) = delete;
+
+    void moveTo(float x, float y);
+    void lineTo(float x, float y);
+
+private:
+    struct vertex { float x, y; size_t index; };
+
+    long long columnOf(float x) const;
+    /// Emits the kept points of the current column run.
+    void flush();
+
+    shapes::geometry &mOut;
+    const qreal mScale;
+    const qreal mOffset;
+
+    bool mRunning = false;
+    long long mColumn = 0;
+    size_t mIndex = 0;
+    vertex mFirst{}, mMin{}, mMax{}, mLast{};
+};
+} // namespace veqtor::utils
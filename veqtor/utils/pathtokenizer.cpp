@@ -0,0 +1,206 @@
+#include <QLocale>
+
+#include <charconv>
+
+#include "pathtokenizer.h"
+
+namespace veqtor::utils {
+using shapes::pathbuffer;
+
+pathbuffer pathTokenizer::parse(QStringView data) {
+    pathbuffer pathData;
+    /// The shortest segments take about five characters and two coordinates (e.g. "l1 1 "),
+    ///  so this reservation avoids reallocation for almost all real-world path data.
+    pathData.reserve(data.size() / 5 + 1, 2 * (data.size() / 5 + 1));
+
+    pathTokenizer tokenizer(data);
+    char command = 0;
+    double v[6];
+
+    const auto numbers = [&tokenizer, &v](int count) {
+        for(int i = 0; i < count; ++i) if(!tokenizer.nextNumber(v[i])) return false;
+        return true;
+    };
+
+    while(!tokenizer.atEnd()) {
+        char next;
+        /// If there is no command letter, the previous command is implicitly repeated.
+        if(tokenizer.nextCommand(next)) command = next;
+        else if(command == 0 || command == 'z' || command == 'Z' || !tokenizer.hasNumber()) break;
+
+        const bool relative = command >= 'a';
+        bool valid = true;
+
+        switch(command | 0x20) {
+            case 'z': pathData.close(); break;
+            case 'm':
+                if((valid = numbers(2))) pathData.moveTo(apoint{v[0], v[1]}, relative);
+                /// Extra coordinate pairs after a `moveTo` are implicit `lineTo` commands.
+                command = relative ? 'l' : 'L';
+                break;
+            case 'l':
+                if((valid = numbers(2))) pathData.lineTo(apoint{v[0], v[1]}, relative);
+                break;
+            case 'h':
+                if((valid = numbers(1))) pathData.hTo(v[0], relative);
+                break;
+            case 'v':
+                if((valid = numbers(1))) pathData.vTo(v[0], relative);
+                break;
+            case 'q':
+                if((valid = numbers(4))) pathData.quadTo(apoint{v[0], v[1]}, apoint{v[2], v[3]}, relative);
+                break;
+            case 't':
+                if((valid = numbers(2))) pathData.shortQuadTo(apoint{v[0], v[1]}, relative);
+                break;
+            case 'c':
+                if((valid = numbers(6))) {
+                    pathData.cubicTo(apoint{v[0], v[1]}, apoint{v[2], v[3]}, apoint{v[4], v[5]}, relative);
+                }
+                break;
+            case 's':
+                if((valid = numbers(4))) pathData.shortCubicTo(apoint{v[0], v[1]}, apoint{v[2], v[3]}, relative);
+                break;
+            case 'a': {
+                bool largeArc = false, sweep = false;
+                valid = numbers(3) && tokenizer.nextFlag(largeArc) && tokenizer.nextFlag(sweep) &&
+                        tokenizer.nextNumber(v[3]) && tokenizer.nextNumber(v[4]);
+                if(valid) pathData.arcTo(apoint{v[3], v[4]}, QSizeF{v[0], v[1]}, v[2], largeArc, sweep, relative);
+                break;
+            }
+            default: valid = false;
+        }
+
+        if(!valid) break;
+    }
+
+    if(!tokenizer.atEnd()) {
+        qWarning("Veqtor: invalid path data at position %lld.", static_cast<long long>(tokenizer.mPos));
+    }
+
+    pathData.squeeze();
+    return pathData;
+}
+
+std::vector<double> pathTokenizer::parseNumbers(QStringView data) {
+    std::vector<double> numbers;
+    pathTokenizer tokenizer(data);
+    double value;
+    while(tokenizer.nextNumber(value)) {
+        numbers.push_back(value);
+        /// Ignore `px` units (e.g. viewBox="0 0 100px 100px").
+        if(tokenizer.mData.mid(tokenizer.mPos).startsWith(QLatin1String("px"))) {
+            tokenizer.mPos += 2;
+        }
+    }
+    return numbers;
+}
+
+bool pathTokenizer::nextCommand(char &command) {
+    skipSeparators();
+    if(mPos >= mData.size()) return false;
+
+    switch(mData[mPos].unicode()) {
+        case 'M': case 'm': case 'Z': case 'z': case 'L': case 'l':
+        case 'H': case 'h': case 'V': case 'v': case 'C': case 'c':
+        case 'S': case 's': case 'Q': case 'q': case 'T': case 't':
+        case 'A': case 'a':
+            command = static_cast<char>(mData[mPos++].unicode());
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool pathTokenizer::hasNumber() {
+    skipSeparators();
+    if(mPos >= mData.size()) return false;
+    const char16_t c = mData[mPos].unicode();
+    return isDigit(c) || c == '-' || c == '+' || c == '.';
+}
+
+bool pathTokenizer::nextNumber(double &value) {
+    skipSeparators();
+
+    const qsizetype size = mData.size();
+    const qsizetype start = mPos;
+    qsizetype i = mPos;
+    const auto at = [this, size](qsizetype index) -> char16_t {
+        return index < size ? mData[index].unicode() : u'\0';
+    };
+
+    if(at(i) == '+' || at(i) == '-') ++i;
+
+    const qsizetype integerStart = i;
+    while(isDigit(at(i))) ++i;
+    bool hasDigits = i > integerStart;
+
+    /// A second dot starts a new number, so "1.5.5" is read as "1.5" and ".5".
+    if(at(i) == '.') {
+        const qsizetype fractionStart = ++i;
+        while(isDigit(at(i))) ++i;
+        hasDigits = hasDigits || i > fractionStart;
+    }
+
+    if(!hasDigits) return false;
+
+    /// Exponent is accepted only if it is followed by digits.
+    if(at(i) == 'e' || at(i) == 'E') {
+        qsizetype e = i + 1;
+        if(at(e) == '+' || at(e) == '-') ++e;
+        if(isDigit(at(e))) {
+            while(isDigit(at(e))) ++e;
+            i = e;
+        }
+    }
+
+    /// `from_chars` does not accept a leading plus sign.
+    const qsizetype numberStart = at(start) == '+' ? start + 1 : start;
+    const qsizetype length = i - numberStart;
+    bool converted = false;
+
+#if defined(__cpp_lib_to_chars)
+    /// The token only contains ASCII characters, so it can be narrowed into a stack buffer.
+    char buffer[64];
+    if(length < qsizetype(sizeof(buffer))) {
+        for(qsizetype j = 0; j < length; ++j) {
+            buffer[j] = static_cast<char>(mData[numberStart + j].unicode());
+        }
+        converted = std::from_chars(buffer, buffer + length, value).ec == std::errc();
+    }
+#endif
+
+    if(!converted) {
+        value = QLocale::c().toDouble(mData.mid(numberStart, length), &converted);
+    }
+
+    mPos = i;
+    skipSeparators();
+    return converted;
+}
+
+bool pathTokenizer::nextFlag(bool &flag) {
+    skipSeparators();
+    if(mPos >= mData.size()) return false;
+
+    const char16_t c = mData[mPos].unicode();
+    if(c != '0' && c != '1') return false;
+
+    flag = c == '1';
+    ++mPos;
+    skipSeparators();
+    return true;
+}
+
+void pathTokenizer::skipSpaces() {
+    while(mPos < mData.size() && isSpace(mData[mPos].unicode())) ++mPos;
+}
+
+void pathTokenizer::skipSeparators() {
+    skipSpaces();
+    if(mPos < mData.size() && mData[mPos] == QLatin1Char(',')) {
+        ++mPos;
+        skipSpaces();
+    }
+}
+} // namespace veqtor::utils
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QStringView>
+
+#include <vector>
+
+#include "../shapes/path.h"
+
+namespace veqtor::utils {
+/**
+ * @brief The pathTokenizer class
+ * @abstract Single-pass scanner over SVG path data (the `d` attribute).
+ *  It reads directly from the UTF-16 buffer of the string, without any intermediate token strings,
+ *  and follows the SVG 1.1 path grammar:
+ * @list
+ * @li numbers with optional sign, fraction and exponent (`-1.5e-3`),
+ * @li implicit separators between numbers (`1.5.5` => `1.5 .5`, `1-2` => `1 -2`),
+ * @li packed arc flags (`a1 1 0 016 8` => flags `0`, `1` then `6 8`),
+ * @li implicit repeated commands (`M0 0 10 10` => `M0 0 L10 10`).
+ * @endlist
+ */
+class pathTokenizer {
+public:
+    explicit pathTokenizer(QStringView data): mData(data), mPos(0) {}
+
+    /**
+     * @brief parse
+     * @abstract Tokenizes the whole path data and appends the segments to a pre-reserved path buffer.
+     *  Parsing stops at the first malformed token; the segments before it are kept (as SVG requires).
+     * @param data, SVG path data.
+     * @return path buffer, with absolute coordinates.
+     */
+    static shapes::pathbuffer parse(QStringView data);
+
+    /**
+     * @brief parseNumbers
+     * @abstract Reads a list of separated numbers (e.g. viewBox, points) until the first non-number.
+     * @param data, number list.
+     * @return numbers as a vector of double.
+     */
+    static std::vector<double> parseNumbers(QStringView data);
+
+    bool atEnd() { skipSeparators(); return mPos >= mData.size(); }
+    /** @brief nextCommand, reads a path command letter. return false if the next token is not a command. */
+    bool nextCommand(char &command);
+    /** @brief nextNumber, reads a number followed by optional separators. */
+    bool nextNumber(double &value);
+    /** @brief nextFlag, reads a single `0` or `1` arc flag followed by optional separators. */
+    bool nextFlag(bool &flag);
+    /** @brief hasNumber, check if the next token is the start of a number. */
+    bool hasNumber();
+
+private:
+    static bool isSpace(char16_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+    static bool isDigit(char16_t c) { return c >= '0' && c <= '9'; }
+    void skipSpaces();
+    void skipSeparators();
+
+    QStringView mData;
+    qsizetype mPos;
+};
+} // namespace veqtor::utils
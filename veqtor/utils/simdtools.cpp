@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "simdtools.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VEQTOR_SIMD_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VEQTOR_SIMD_SSE2
+#endif
+
+namespace veqtor::utils {
+void simdTools::transform(float *xy, size_t count, const QTransform &t) {
+    if(t.isIdentity() || count == 0) return;
+
+    if(!t.isAffine()) {
+        for(size_t i = 0; i < count; ++i) {
+            const QPointF p = t.map(QPointF(xy[2 * i], xy[2 * i + 1]));
+            xy[2 * i] = float(p.x());
+            xy[2 * i + 1] = float(p.y());
+        }
+        return;
+    }
+
+    const float m11 = t.m11(), m12 = t.m12(), m21 = t.m21(), m22 = t.m22(), dx = t.dx(), dy = t.dy();
+    size_t i = 0;
+
+    /// x' = m11 x + m21 y + dx and y' = m12 x + m22 y + dy, so each register is multiplied by
+    ///  (m11, m22) and its swapped pairs (y, x) by (m21, m12).
+#if defined(VEQTOR_SIMD_AVX2)
+    {
+        const __m256 a = _mm256_setr_ps(m11, m22, m11, m22, m11, m22, m11, m22);
+        const __m256 b = _mm256_setr_ps(m21, m12, m21, m12, m21, m12, m21, m12);
+        const __m256 d = _mm256_setr_ps(dx, dy, dx, dy, dx, dy, dx, dy);
+        for(; i + 4 <= count; i += 4) {
+            const __m256 p = _mm256_loadu_ps(xy + 2 * i);
+            const __m256 s = _mm256_permute_ps(p, _MM_SHUFFLE(2, 3, 0, 1));
+            _mm256_storeu_ps(xy + 2 * i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, a), _mm256_mul_ps(s, b)), d));
+        }
+    }
+#endif
+#if defined(VEQTOR_SIMD_SSE2)
+    {
+        const __m128 a = _mm_setr_ps(m11, m22, m11, m22);
+        const __m128 b = _mm_setr_ps(m21, m12, m21, m12);
+        const __m128 d = _mm_setr_ps(dx, dy, dx, dy);
+        for(; i + 2 <= count; i += 2) {
+            const __m128 p = _mm_loadu_ps(xy + 2 * i);
+            const __m128 s = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1));
+            _mm_storeu_ps(xy + 2 * i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, a), _mm_mul_ps(s, b)), d));
+        }
+    }
+#endif
+
+    for(; i < count; ++i) {
+        const float x = xy[2 * i], y = xy[2 * i + 1];
+        xy[2 * i] = m11 * x + m21 * y + dx;
+        xy[2 * i + 1] = m12 * x + m22 * y + dy;
+    }
+}
+
+void simdTools::expand(extent &e, const float *xy, size_t count) {
+    size_t i = 0;
+
+#if defined(VEQTOR_SIMD_SSE2)
+    if(count >= 2) {
+        /// Each register holds the minimums (or maximums) of two points, they're folded at the end.
+        __m128 lo = _mm_setr_ps(e.left, e.top, e.left, e.top);
+        __m128 hi = _mm_setr_ps(e.right, e.bottom, e.right, e.bottom);
+#if defined(VEQTOR_SIMD_AVX2)
+        if(count >= 4) {
+            __m256 lo8 = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), lo, 1);
+            __m256 hi8 = _mm256_insertf128_ps(_mm256_castps128_ps256(hi), hi, 1);
+            for(; i + 4 <= count; i += 4) {
+                const __m256 p = _mm256_loadu_ps(xy + 2 * i);
+                lo8 = _mm256_min_ps(lo8, p);
+                hi8 = _mm256_max_ps(hi8, p);
+            }
+            lo = _mm_min_ps(_mm256_castps256_ps128(lo8), _mm256_extractf128_ps(lo8, 1));
+            hi = _mm_max_ps(_mm256_castps256_ps128(hi8), _mm256_extractf128_ps(hi8, 1));
+        }
+#endif
+        for(; i + 2 <= count; i += 2) {
+            const __m128 p = _mm_loadu_ps(xy + 2 * i);
+            lo = _mm_min_ps(lo, p);
+            hi = _mm_max_ps(hi, p);
+        }
+        lo = _mm_min_ps(lo, _mm_movehl_ps(lo, lo));
+        hi = _mm_max_ps(hi, _mm_movehl_ps(hi, hi));
+
+        alignas(16) float l[4], h[4];
+        _mm_store_ps(l, lo);
+        _mm_store_ps(h, hi);
+        e.left = l[0]; e.top = l[1];
+        e.right = h[0]; e.bottom = h[1];
+    }
+#endif
+
+    for(; i < count; ++i) {
+        const float x = xy[2 * i], y = xy[2 * i + 1];
+        e.left = std::min(e.left, x); e.right = std::max(e.right, x);
+        e.top = std::min(e.top, y); e.bottom = std::max(e.bottom, y);
+    }
+}
+
+void simdTools::intersects(const float *rects, size_t count, const QRectF &rect, std::uint8_t *result) {
+    const float left = rect.left(), top = rect.top(), right = rect.right(), bottom = rect.bottom();
+    size_t i = 0;
+
+    /// A rect intersects if (left, top, right, bottom) <= (right, bottom, inf, inf) and >= (-inf, -inf, left, top).
+#if defined(VEQTOR_SIMD_AVX2)
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        const __m256 hi = _mm256_setr_ps(right, bottom, inf, inf, right, bottom, inf, inf);
+        const __m256 lo = _mm256_setr_ps(-inf, -inf, left, top, -inf, -inf, left, top);
+        for(; i + 2 <= count; i += 2) {
+            const __m256 r = _mm256_loadu_ps(rects + 4 * i);
+            const int mask = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(r, hi, _CMP_LE_OQ),
+                                                              _mm256_cmp_ps(r, lo, _CMP_GE_OQ)));
+            result[i] = (mask & 0xF) == 0xF;
+            result[i + 1] = (mask >> 4) == 0xF;
+        }
+    }
+#endif
+#if defined(VEQTOR_SIMD_SSE2)
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        const __m128 hi = _mm_setr_ps(right, bottom, inf, inf);
+        const __m128 lo = _mm_setr_ps(-inf, -inf, left, top);
+        for(; i < count; ++i) {
+            const __m128 r = _mm_loadu_ps(rects + 4 * i);
+            result[i] = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(r, hi), _mm_cmpge_ps(r, lo))) == 0xF;
+        }
+    }
+#endif
+
+    for(; i < count; ++i) {
+        const float *r = rects + 4 * i;
+        result[i] = r[0] <= right && r[1] <= bottom && r[2] >= left && r[3] >= top;
+    }
+}
+} // namespace veqtor::utils
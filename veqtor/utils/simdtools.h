@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QRectF>
+#include <QTransform>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace veqtor::utils {
+/**
+ * @brief The simdTools class
+ * @abstract Batch kernels over packed float coordinates (x0, y0, x1, y1, ...).
+ *  They use AVX2 if the library is built with it (`-mavx2`), otherwise SSE2 on x86 and a scalar loop elsewhere.
+ *  The scalar loop also handles the remaining points of the vector loops.
+ */
+class simdTools {
+public:
+    /** @brief The extent struct, a float bounding box that is expanded by `expand`. */
+    struct extent {
+        float left   = std::numeric_limits<float>::max();
+        float top    = std::numeric_limits<float>::max();
+        float right  = std::numeric_limits<float>::lowest();
+        float bottom = std::numeric_limits<float>::lowest();
+
+        bool isEmpty() const { return left > right; }
+        void unite(const extent &e) {
+            left = std::min(left, e.left); top = std::min(top, e.top);
+            right = std::max(right, e.right); bottom = std::max(bottom, e.bottom);
+        }
+        QRectF rect() const { return isEmpty() ? QRectF() : QRectF(QPointF(left, top), QPointF(right, bottom)); }
+    };
+
+    /**
+     * @brief transform
+     * @abstract Maps @a count packed points in place. Projective transforms fall back to `QTransform::map`.
+     */
+    static void transform(float *xy, size_t count, const QTransform &transform);
+
+    /**
+     * @brief expand
+     * @abstract Expands @a e to contain @a count packed points.
+     */
+    static void expand(extent &e, const float *xy, size_t count);
+
+    /** @return The bounding box of @a count packed points, or a null rect if there is no point. */
+    static QRectF bounds(const float *xy, size_t count) {
+        extent e;
+        expand(e, xy, count);
+        return e.rect();
+    }
+
+    /**
+     * @brief intersects
+     * @abstract Tests @a count packed rects (left, top, right, bottom) against @a rect, touching edges intersect.
+     * @param result, receives 1 for each intersecting rect and 0 for the others.
+     */
+    static void intersects(const float *rects, size_t count, const QRectF &rect, std::uint8_t *result);
+};
+} // namespace veqtor::utils
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#include "spatialindex.h"
+
+namespace veqtor::utils {
+/// Items that cover more buckets than this are not split into the grid.
+constexpr int maxItemCells = 64;
+constexpr int maxGridSide = 256;
+
+void spatialIndex::reset(const QRectF &bounds, int count) {
+    mBounds = bounds.normalized();
+    mCount = 0;
+    /// About two items per bucket.
+    const int side = mBounds.isEmpty() ? 1 : std::clamp(int(std::ceil(std::sqrt(count / 2.0))), 1, maxGridSide);
+    mColumns = mRows = side;
+    mCellWidth = mBounds.isEmpty() ? 1 : mBounds.width() / mColumns;
+    mCellHeight = mBounds.isEmpty() ? 1 : mBounds.height() / mRows;
+
+    mBuckets.assign(size_t(mColumns) * mRows, {});
+    mLarge.clear();
+    mRects.clear();
+    mPresent.clear();
+}
+
+void spatialIndex::insert(int id, const QRectF &rect) {
+    if(id < 0) return;
+    if(size_t(id) >= mRects.size()) {
+        mRects.resize(id + 1);
+        mPresent.resize(id + 1, false);
+    }
+    if(mPresent[id]) remove(id);
+
+    mRects[id] = rect;
+    mPresent[id] = true;
+    ++mCount;
+
+    const cellRange range = cells(rect);
+    if(isLarge(range)) {
+        mLarge.push_back(id);
+        return;
+    }
+    for(int row = range.top; row <= range.bottom; ++row) {
+        for(int column = range.left; column <= range.right; ++column) {
+            bucket(column, row).push_back(id);
+        }
+    }
+}
+
+void spatialIndex::update(int id, const QRectF &rect) {
+    if(id >= 0 && size_t(id) < mRects.size() && mPresent[id] && mRects[id] == rect) return;
+    insert(id, rect);
+}
+
+void spatialIndex::remove(int id) {
+    if(id < 0 || size_t(id) >= mRects.size() || !mPresent[id]) return;
+
+    const cellRange range = cells(mRects[id]);
+    if(isLarge(range)) {
+        erase(mLarge, id);
+    } else {
+        for(int row = range.top; row <= range.bottom; ++row) {
+            for(int column = range.left; column <= range.right; ++column) {
+                erase(bucket(column, row), id);
+            }
+        }
+    }
+    mPresent[id] = false;
+    --mCount;
+}
+
+std::vector<int> spatialIndex::query(const QPointF &point) const {
+    const int column = mBounds.isEmpty() ? 0 : columnAt(point.x()), row = mBounds.isEmpty() ? 0 : rowAt(point.y());
+    return collect({column, row, column, row}, QRectF(point, QSizeF(0, 0)));
+}
+
+std::vector<int> spatialIndex::query(const QRectF &rect) const {
+    return collect(cells(rect), rect);
+}
+
+std::vector<int> spatialIndex::collect(const cellRange &range, const QRectF &rect) const {
+    std::vector<int> result;
+    const auto gather = [&](const std::vector<int> &ids) {
+        for(const int id: ids) if(hits(mRects[id], rect)) result.push_back(id);
+    };
+
+    for(int row = range.top; row <= range.bottom; ++row) {
+        for(int column = range.left; column <= range.right; ++column) {
+            gather(bucket(column, row));
+        }
+    }
+    gather(mLarge);
+
+    /// Topmost (last painted) first, an item that spans several buckets is reported once.
+    std::sort(result.begin(), result.end(), std::greater<int>());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+spatialIndex::cellRange spatialIndex::cells(const QRectF &rect) const {
+    if(rect.isNull() || mBounds.isEmpty()) return {0, 0, mColumns - 1, mRows - 1};
+
+    const QRectF r = rect.normalized();
+    return {columnAt(r.left()), rowAt(r.top()), columnAt(r.right()), rowAt(r.bottom())};
+}
+
+int spatialIndex::columnAt(qreal x) const {
+    return std::clamp(int(std::floor((x - mBounds.left()) / mCellWidth)), 0, mColumns - 1);
+}
+
+int spatialIndex::rowAt(qreal y) const {
+    return std::clamp(int(std::floor((y - mBounds.top()) / mCellHeight)), 0, mRows - 1);
+}
+
+bool spatialIndex::isLarge(const cellRange &range) const {
+    return (range.right - range.left + 1) * (range.bottom - range.top + 1) > maxItemCells;
+}
+
+void spatialIndex::erase(std::vector<int> &ids, int id) {
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if(it != ids.end()) {
+        *it = ids.back();
+        ids.pop_back();
+    }
+}
+
+bool spatialIndex::hits(const QRectF &itemRect, const QRectF &rect) {
+    /// Items with unknown bounds are always candidates.
+    if(itemRect.isNull()) return true;
+    const QRectF a = itemRect.normalized(), b = rect.normalized();
+    return a.left() <= b.right() && b.left() <= a.right() && a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+} // namespace veqtor::utils
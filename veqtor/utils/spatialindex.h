@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QPointF>
+#include <QRectF>
+
+#include <vector>
+
+namespace veqtor::utils {
+/**
+ * @brief The spatialIndex class
+ * @abstract A uniform grid of buckets over the document bounds, that stores items by their bounding rects.
+ *  Items are identified by their paint order (`id`), and queries return ids in reverse paint order (topmost first).
+ *  Moving an item only touches the buckets of its old and new rects, so updates are incremental.
+ *  Items that cover many buckets, or have unknown (null) bounds, are kept in a separate list that is always checked.
+ */
+class spatialIndex {
+public:
+    spatialIndex() = default;
+
+    /**
+     * @brief reset
+     * @abstract Removes all items and re-creates the grid.
+     * @param bounds, Area of the document, items outside of it are kept in the border buckets.
+     * @param count, Expected number of items, it is used to choose the grid size.
+     */
+    void reset(const QRectF &bounds, int count);
+    void clear() { reset(QRectF(), 0); }
+
+    void insert(int id, const QRectF &rect);
+    void update(int id, const QRectF &rect);
+    void remove(int id);
+
+    /** @return ids of the items whose rect contains the point, topmost first. */
+    std::vector<int> query(const QPointF &point) const;
+    /** @return ids of the items whose rect intersects the rect, topmost first. */
+    std::vector<int> query(const QRectF &rect) const;
+
+    int size() const { return mCount; }
+
+private:
+    struct cellRange { int left, top, right, bottom; };
+
+    cellRange cells(const QRectF &rect) const;
+    int columnAt(qreal x) const;
+    int rowAt(qreal y) const;
+    std::vector<int> collect(const cellRange &range, const QRectF &rect) const;
+    bool isLarge(const cellRange &range) const;
+    std::vector<int> &bucket(int column, int row) { return mBuckets[row * mColumns + column]; }
+    const std::vector<int> &bucket(int column, int row) const { return mBuckets[row * mColumns + column]; }
+    static void erase(std::vector<int> &ids, int id);
+    static bool hits(const QRectF &itemRect, const QRectF &rect);
+
+    QRectF mBounds;
+    int mColumns = 1, mRows = 1;
+    qreal mCellWidth = 1, mCellHeight = 1;
+    int mCount = 0;
+
+    std::vector<std::vector<int>> mBuckets = std::vector<std::vector<int>>(1);
+    std::vector<int> mLarge;
+    /// Rect of each item by id, and whether it is present in the index.
+    std::vector<QRectF> mRects;
+    std::vector<bool> mPresent;
+};
+} // namespace veqtor::utils
@@ -1,59 +1,70 @@
+#include <QDebug>
+
 #include "svgtools.h"
 #include "tools.h"
 #include "arctocubic.h"
+#include "pathtokenizer.h"
 
 #include "../shapes/shapes.h"
+#include "../scene.h"
 
 #include "../elements/element.h"
+#include "../elements/container.h"
 #include "../elements/graphic.h"
+#include "../elements/eellipse.h"
+#include "../elements/eline.h"
 #include "../elements/epath.h"
+#include "../elements/epolyline.h"
+#include "../elements/erect.h"
+#include "../elements/eseries.h"
+#include "../elements/group.h"
 #include "../elements/link.h"
 #include "../elements/svg.h"
 #include "../elements/unknown.h"
 
 namespace veqtor::utils {
-QMap<QString, QString> svgTools::getAttrs(const QDomNode &node) {
-    QMap<QString, QString> attrMap;
+attributeList svgTools::getAttrs(const QDomNode &node, const std::shared_ptr<atomTable> &atoms) {
+    attributeList list(atoms);
     QDomNamedNodeMap attrs = node.attributes();
+    list.reserve(attrs.count());
     for(int i = 0; i < attrs.count(); ++i) {
         const auto &attr = attrs.item(i).toAttr();
-        attrMap[attr.name()] = attr.value();
+        list.append(attr.name(), attr.value());
     }
-    return attrMap;
+    return list;
 }
 
-std::vector<shapes::pathdata> svgTools::svgPathParser(const QString &svgPath) {
-    return svgPathParser(svgPath.toStdString());
+shapes::pathbuffer svgTools::svgPathParser(QStringView svgPath) {
+    return pathTokenizer::parse(svgPath);
 }
 
-std::vector<shapes::pathdata> svgTools::svgPathParser(const std::string &svgPath) {
-    static const std::regex reg(R"([a-zA-Z][^a-zA-Z]*)");
-    static const std::regex subReg(R"(-?\d*\.?\d*)");
-    shapes::path path;
+shapes::pathbuffer svgTools::svgPathParser(const QString &svgPath) {
+    return pathTokenizer::parse(svgPath);
+}
 
-    for(const auto &m: tools::globalMatch(svgPath, reg)) {
-        auto v = tools::stodVec(tools::globalMatch(m, subReg));
-        bool relative = std::islower(m[0]);
-        char type = std::tolower(m[0]);
+shapes::pathbuffer svgTools::svgPathParser(const std::string &svgPath) {
+    return svgPathParser(QString::fromStdString(svgPath));
+}
 
-		/// @brief If the type is `moveTo` or `lineTo`, resize the vector to at least 2; otherwise, resize it to 6.
-		v.resize(std::max<size_t>(v.size(), type == 'm' || type == 'l' ? 2ull : 7ull));
+QString svgTools::svgPathString(const shapes::path &path) {
+    using shapes::pathbuffer;
+    static const char commands[] = {'M', 'L', 'Q', 'C', 'A', 'Z'};
 
-        switch (type) {
-            case 'h': path.hTo(v[0], relative); break;
-            case 'v': path.vTo(v[0], relative); break;
-            case 'm': path.moveTo(v, relative); break;
-            case 'l': path.lineTo(v, relative); break;
-            case 'q': path.quadTo({v[0], v[1]}, {v[2], v[3]}, relative); break;
-            case 't': qWarning("Veqtor presently does not support the `t` path line type."); break;
-            case 'c': path.cubicTo(v, relative); break;
-            case 's': path.shortCubicTo({v[0], v[1]}, {v[2], v[3]}, relative); break;
-            case 'a': path.arcTo(v, relative); break;
-            case 'z': path.close(); break;
+    QString d;
+    const auto number = [&d](qreal value) { d += ' '; d += QString::number(value); };
+    for(const pathbuffer::segment s: path) {
+        if(!d.isEmpty()) d += ' ';
+        d += QLatin1Char(commands[s.verb]);
+        if(s.verb == pathbuffer::Arc) {
+            /// The flags are packed into one coordinate.
+            number(s.radius().width()); number(s.radius().height()); number(s.rotation());
+            number(s.largeArc()); number(s.sweepFlag());
+            number(s.to().x()); number(s.to().y());
+        } else {
+            for(int i = 0; i < pathbuffer::coordCount(s.verb); ++i) number(s.coords[i]);
         }
     }
-
-    return path.pathData();
+    return d;
 }
 
 std::vector<shapes::pathdata> svgTools::arcToCubic(const shapes::pd::arc &arc, const QPointF from, const QPointF &to) {
@@ -68,35 +79,90 @@ std::vector<shapes::pathdata> svgTools::arcToCubic(const shapes::pd::arc &arc, c
     return pathList;
 }
 
-QPointer<element> svgTools::elementGenerator(element::Type type, const QMap<QString, QString> &attrs, QObject *parent) {
+QPointer<element> svgTools::elementGenerator(element::Type type, const attributeList &attrs, QObject *parent) {
     using namespace elements;
 
     switch(type) {
         case element::Link: return new link(parent);
         case element::Path: return new epath(attrs, parent);
-        case element::Rect:
-        case element::Circle:
-        case element::Ellipse:
-        case element::Polyline:
-        case element::Polygon:
+        case element::Series: return new eseries(attrs, parent);
+        case element::Line: return new eline(attrs, parent);
+        case element::Rect: return new erect(attrs, parent);
+        case element::Circle: return new ecircle(attrs, parent);
+        case element::Ellipse: return new eellipse(attrs, parent);
+        case element::Polyline: return new epolyline(attrs, parent);
+        case element::Polygon: return new epolygon(attrs, parent);
         case element::Text:
         case element::TextPath: return new graphic(parent);
         case element::SVG: return new svg(attrs, parent);
-        case element::Group:
+        case element::Group: return new group(attrs, parent);
         default: return new unknown(parent);
     };
     return nullptr;
 }
 
-QPointer<element> svgTools::domToElement(const QDomNode &node, QObject *parent) {
+QPointer<element> svgTools::elementGenerator(element::Type type, const attributeList &attrs,
+                                             const std::shared_ptr<shapes::shape> &shape, QObject *parent) {
+    using namespace elements;
+    using std::static_pointer_cast;
+    if(!shape) return elementGenerator(type, attrs, parent);
+
+    switch(type) {
+        case element::Path: return new epath(static_pointer_cast<shapes::path>(shape), attrs, parent);
+        case element::Series: return new eseries(static_pointer_cast<shapes::series>(shape), attrs, parent);
+        case element::Line: return new eline(static_pointer_cast<shapes::line>(shape), attrs, parent);
+        case element::Rect: return new erect(static_pointer_cast<shapes::rect>(shape), attrs, parent);
+        case element::Circle: return new ecircle(static_pointer_cast<shapes::ellipse>(shape), attrs, parent);
+        case element::Ellipse: return new eellipse(static_pointer_cast<shapes::ellipse>(shape), attrs, parent);
+        case element::Polyline: return new epolyline(static_pointer_cast<shapes::path>(shape), attrs, parent);
+        case element::Polygon: return new epolygon(static_pointer_cast<shapes::path>(shape), attrs, parent);
+        default: return elementGenerator(type, attrs, parent);
+    };
+}
+
+std::shared_ptr<shapes::shape> svgTools::shapeGenerator(element::Type type, const attributeList &attrs) {
+    using namespace elements;
+
+    std::shared_ptr<shapes::shape> shape;
+    switch(type) {
+        case element::Path: shape = epath::shapeFrom(attrs); break;
+        case element::Series: shape = eseries::shapeFrom(attrs); break;
+        case element::Line: shape = eline::shapeFrom(attrs); break;
+        case element::Rect: shape = erect::shapeFrom(attrs); break;
+        case element::Circle: shape = ecircle::shapeFrom(attrs); break;
+        case element::Ellipse: shape = eellipse::shapeFrom(attrs); break;
+        case element::Polyline: shape = epolyline::shapeFrom(attrs, false); break;
+        case element::Polygon: shape = epolyline::shapeFrom(attrs, true); break;
+        default: return nullptr;
+    };
+    shape->setPen(graphic::parsePen(attrs));
+    return shape;
+}
+
+QStringList svgTools::shapeAttributes(element::Type type) {
+    switch(type) {
+        case element::Path: return {"d"};
+        case element::Series: return {"capacity"};
+        case element::Line: return {"x1", "y1", "x2", "y2"};
+        case element::Rect: return {"x", "y", "width", "height", "rx", "ry"};
+        case element::Circle: return {"cx", "cy", "r"};
+        case element::Ellipse: return {"cx", "cy", "rx", "ry"};
+        case element::Polyline:
+        case element::Polygon: return {"points"};
+        default: return {};
+    };
+}
+
+QPointer<element> svgTools::domToElement(const QDomNode &node, QObject *parent, std::shared_ptr<atomTable> atoms) {
+    if(!atoms) atoms = std::make_shared<atomTable>();
     QString tagname = node.toElement().tagName();
     element::Type type = mElementTypeMap[tagname];
-    QPointer<element> veqtorElement = elementGenerator(type, getAttrs(node), parent);
+    QPointer<element> veqtorElement = elementGenerator(type, getAttrs(node, atoms), parent);
 
     if(veqtorElement && type && type > element::Container) {
         auto cont = dynamic_cast<elements::container*>(veqtorElement.data());
         for(auto n = node.firstChild(); cont && !n.isNull(); n = n.nextSibling()) {
-            cont->push_back(domToElement(n, veqtorElement));
+            cont->push_back(domToElement(n, veqtorElement, atoms));
         }
     }
 
@@ -108,7 +174,7 @@ QPointer<element> svgTools::domToElement(const QDomNode &node, QObject *parent)
     return veqtorElement;
 }
 
-QPointer<element> svgTools::svgParser(const QString &svgString, QObject *parent) {
+QPointer<element> svgTools::svgDomParser(const QString &svgString, QObject *parent) {
     if(svgString.isEmpty()) return nullptr;
 
     QDomDocument document;
@@ -116,11 +182,128 @@ QPointer<element> svgTools::svgParser(const QString &svgString, QObject *parent)
     return domToElement(document.firstChild(), parent);
 }
 
+attributeList svgTools::getAttrs(const QXmlStreamAttributes &attributes, const std::shared_ptr<atomTable> &atoms) {
+    attributeList list(atoms);
+    list.reserve(attributes.size());
+    /// The attributes of an XML element are unique, so they are appended without a lookup.
+    for(const auto &attr: attributes) {
+        list.append(QStringView(attr.qualifiedName()), attr.value().toString());
+    }
+    return list;
+}
+
+element::Type svgTools::elementType(QStringView tagName) {
+    for(auto i = mElementTypeMap.cbegin(); i != mElementTypeMap.cend(); ++i) {
+        if(i.key() == tagName) return i.value();
+    }
+    return element::Unknown;
+}
+
+QPointer<element> svgTools::svgParser(const QString &svgString, QObject *parent,
+                                      const std::function<bool(qreal)> &progress) {
+    if(svgString.isEmpty()) return nullptr;
+
+    QXmlStreamReader reader(svgString);
+    /// Attribute names are interned once per document, so all elements share the same names.
+    const auto atoms = std::make_shared<atomTable>();
+    QPointer<element> root;
+    /// Stack of the currently open container elements.
+    std::vector<elements::container *> parents;
+
+    while(!reader.atEnd()) {
+        const auto token = reader.readNext();
+
+        if(token == QXmlStreamReader::StartElement) {
+            if(progress && !progress(qreal(reader.characterOffset()) / svgString.size())) {
+                delete root.data();
+                return nullptr;
+            }
+
+            const element::Type type = elementType(QStringView(reader.name()));
+            QObject *owner = parents.empty() ? parent : parents.back();
+            QPointer<element> veqtorElement = elementGenerator(type, getAttrs(reader.attributes(), atoms), owner);
+
+            if(!root) root = veqtorElement;
+            else if(!parents.empty()) parents.back()->push_back(veqtorElement);
+
+            if(auto cont = dynamic_cast<elements::container *>(veqtorElement.data())) {
+                parents.push_back(cont);
+            } else {
+                /// Children of non-container elements (e.g. <title> in a <path>) are not supported yet.
+                reader.skipCurrentElement();
+            }
+
+            if(parents.empty()) break;
+        } else if(token == QXmlStreamReader::EndElement) {
+            /// Non-container elements consume their own end tag, so this always closes a container.
+            parents.pop_back();
+            if(parents.empty()) break;
+        }
+    }
+
+    if(reader.hasError()) {
+        qWarning() << "Veqtor: SVG parse error at line" << reader.lineNumber() << ":" << reader.errorString();
+    }
+
+    if(progress && !progress(1.0)) {
+        delete root.data();
+        return nullptr;
+    }
+
+    return root;
+}
+
+std::shared_ptr<core::scene> svgTools::sceneParser(const QString &svgString,
+                                                   const std::function<bool(qreal)> &progress) {
+    if(svgString.isEmpty()) return nullptr;
+
+    QXmlStreamReader reader(svgString);
+    auto scene = std::make_shared<core::scene>();
+    /// Number of the currently open container nodes.
+    int depth = 0;
+
+    while(!reader.atEnd()) {
+        const auto token = reader.readNext();
+
+        if(token == QXmlStreamReader::StartElement) {
+            if(progress && !progress(qreal(reader.characterOffset()) / svgString.size())) return nullptr;
+
+            const element::Type type = elementType(QStringView(reader.name()));
+            auto attrs = getAttrs(reader.attributes(), scene->atoms());
+            auto shape = shapeGenerator(type, attrs);
+            /// The shape is the only copy of the geometry, the elements of the nodes are created around it.
+            if(shape) attrs.remove(shapeAttributes(type));
+            scene->open(type, std::move(attrs), std::move(shape));
+
+            if(type > element::Container) {
+                ++depth;
+            } else {
+                /// Children of non-container elements are not supported, the same as `svgParser`.
+                reader.skipCurrentElement();
+                scene->close();
+            }
+
+            if(!depth) break;
+        } else if(token == QXmlStreamReader::EndElement) {
+            scene->close();
+            if(!--depth) break;
+        }
+    }
+
+    if(reader.hasError()) {
+        qWarning() << "Veqtor: SVG parse error at line" << reader.lineNumber() << ":" << reader.errorString();
+    }
+
+    if(progress && !progress(1.0)) return nullptr;
+
+    scene->finalize();
+    return scene;
+}
+
 QRectF svgTools::parseViewBox(const QString &viewBox) {
     if(viewBox.isNull()) return QRectF();
-    static const std::regex reg(R"(-?\d*\.?\d*(px)?)");
-    auto m = tools::stodVec(tools::globalMatch(viewBox.toStdString(), reg));
-    m.resize(4, 0.0f);
+    auto m = pathTokenizer::parseNumbers(viewBox);
+    m.resize(4, 0.0);
     /// @brief viewbox = "x, y, width, height"
     return QRectF(m[0], m[1], m[2], m[3]);
 }
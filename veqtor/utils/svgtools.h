@@ -1,15 +1,23 @@
 #pragma once
 
 #include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QPointer>
 #include <QString>
 #include <QMap>
 
+#include <functional>
 #include <memory>
-#include <regex>
 
 #include "../shapes/path.h"
 #include "../elements/element.h"
+#include "atomtable.h"
+#include "attributelist.h"
+#include "pathtokenizer.h"
+
+namespace veqtor::core {
+class scene;
+}
 
 namespace veqtor::utils {
 using elements::element;
@@ -25,13 +33,23 @@ public:
      * @li m|M {x  y}
      * @li l|L {x  y}
      * @li q|Q {x1 y1, x y}
+     * @li t|T {x y}
      * @li c|C {x1 y1, x2 y2, x y}
+     * @li s|S {x2 y2, x y}
      * @li a|A {rx ry x-axis-rotation large-arc-flag sweep-flag x y}
      * @brief svgPathParser
-     * @abstract Converts an svg path string to a `pathdata` vector.
+     * @abstract Converts an svg path string to a `pathbuffer`, relative segments are resolved to absolute ones.
+     *  The string is scanned in a single pass by `pathTokenizer`, without regex or temporary strings.
+     */
+    static shapes::pathbuffer svgPathParser(QStringView svgPath);
+    static shapes::pathbuffer svgPathParser(const QString &svgPath);
+    static shapes::pathbuffer svgPathParser(const std::string &svgPath);
+    /**
+     * @brief svgPathString
+     * @abstract Converts a path to an svg path string of absolute segments, e.g. for the `d` of an element that
+     *  is created around a parsed shape.
      */
-    static std::vector<shapes::pathdata> svgPathParser(const QString &svgPath);
-    static std::vector<shapes::pathdata> svgPathParser(const std::string &svgPath);
+    static QString svgPathString(const shapes::path &path);
 
     /**
      * @abstract This function converts an SVG arc curve to a list of cubic curves.
@@ -43,9 +61,25 @@ public:
     /**
      * @brief getAttrs
      * @param node
-     * @return all element attributes as a QMap object.
+     * @param atoms, The document atom table, attribute names are interned in it.
+     * @return all element attributes as an attribute list.
+     */
+    static attributeList getAttrs(const QDomNode &node, const std::shared_ptr<atomTable> &atoms);
+
+    /**
+     * @brief getAttrs
+     * @param attributes, Attributes of the current stream reader element.
+     * @param atoms, The document atom table, attribute names are interned in it.
+     * @return all element attributes as an attribute list.
      */
-    static QMap<QString, QString> getAttrs(const QDomNode &node);
+    static attributeList getAttrs(const QXmlStreamAttributes &attributes, const std::shared_ptr<atomTable> &atoms);
+
+    /**
+     * @brief elementType
+     * @param tagName
+     * @return The element type of the given tag name, or `element::Unknown`.
+     */
+    static element::Type elementType(QStringView tagName);
 
     /**
      * @brief elementGenerator
@@ -54,21 +88,67 @@ public:
      * @param attrs
      * @return created element as QPointer<element>
      */
-    static QPointer<element> elementGenerator(element::Type type, const QMap<QString, QString> &attrs, QObject *parent = nullptr);
+    static QPointer<element> elementGenerator(element::Type type, const attributeList &attrs, QObject *parent = nullptr);
+    /**
+     * @brief elementGenerator
+     * @abstract Creates the element around a @a shape that is built by `shapeGenerator`, so its geometry attributes
+     *  are not parsed again (they may be dropped from @a attrs, see `shapeAttributes`).
+     */
+    static QPointer<element> elementGenerator(element::Type type, const attributeList &attrs,
+                                              const std::shared_ptr<shapes::shape> &shape, QObject *parent);
+
+    /**
+     * @brief shapeGenerator
+     * @abstract Builds the shape (with its pen) of the given element type, the same as its element would.
+     * @param type
+     * @param attrs
+     * @return The shape, or nullptr if the type is not a supported graphic.
+     */
+    static std::shared_ptr<shapes::shape> shapeGenerator(element::Type type, const attributeList &attrs);
+    /** @return The attributes that the shape of the given element type is built from. */
+    static QStringList shapeAttributes(element::Type type);
 
     /**
      * @brief domToElement
      * @param node
+     * @param atoms, The document atom table, a new one is used if it's null.
      * @return A shared pointer to the element tree's root.
      */
-    static QPointer<element> domToElement(const QDomNode &node, QObject *parent = nullptr);
+    static QPointer<element> domToElement(const QDomNode &node, QObject *parent = nullptr,
+                                          std::shared_ptr<atomTable> atoms = {});
 
     /**
      * @brief svgParser
+     * @abstract Builds the element tree directly from a QXmlStreamReader pull parser,
+     *  without an intermediate DOM.
+     * @param svgString
+     * @param parent
+     * @param progress, Optional callback that receives the parsed fraction (0 to 1) of the document.
+     *  If it returns false, parsing is cancelled, the partial tree is deleted and nullptr is returned.
+     * @return A pointer to the element tree's root.
+     */
+    static QPointer<element> svgParser(const QString &svgString, QObject *parent = nullptr,
+                                       const std::function<bool(qreal)> &progress = {});
+
+    /**
+     * @brief svgDomParser
+     * @abstract Builds the element tree by walking a full QDomDocument.
      * @param svgString
-     * @return
+     * @return A pointer to the element tree's root.
+     * @see svgParser
      */
-    static QPointer<element> svgParser(const QString &svgString, QObject *parent = nullptr);
+    static QPointer<element> svgDomParser(const QString &svgString, QObject *parent = nullptr);
+
+    /**
+     * @brief sceneParser
+     * @abstract Builds a `core::scene` with the pull parser of `svgParser`. No QObject is created, so the scene
+     *  can be built on a worker thread and used in another one; elements are created by the scene on demand.
+     * @param svgString
+     * @param progress, The same as the `svgParser` progress callback.
+     * @return The scene, or nullptr if the string is empty or parsing is cancelled.
+     */
+    static std::shared_ptr<core::scene> sceneParser(const QString &svgString,
+                                                    const std::function<bool(qreal)> &progress = {});
 
     /**
      * @abstract Convert an SVG hex color that contains an alpha value to a hex color that is compatible with Qt.
@@ -105,6 +185,18 @@ public:
         return width.isEmpty() ? 1.0f : width.toFloat();
     }
 
+    /**
+     * @brief normLength
+     * @abstract Takes a length attribute (e.g. x, width, r) and returns its number in user units.
+     *  Units are ignored, so "10px" is 10. Percentages are not resolved.
+     * @param length
+     * @param fallback, The value of a missing or invalid length.
+     */
+    static qreal normLength(const QString &length, qreal fallback = 0.0) {
+        const auto numbers = pathTokenizer::parseNumbers(length);
+        return numbers.empty() ? fallback : numbers.front();
+    }
+
     /**
      * @abstract This function parses a viewBox string in SVG format to a QRectF object.
      * @param viewBox, viewBox string in SVG format
@@ -125,6 +217,8 @@ private:
         {"svg",      element::SVG     },
         {"a",        element::Link    },
         {"g",        element::Group   },
+        /// Veqtor extension, a streaming polyline for plots.
+        {"series",   element::Series  },
     };
 };
 }
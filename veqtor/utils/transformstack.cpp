@@ -0,0 +1,180 @@
+#include <cmath>
+#include <algorithm>
+
+#include "transformstack.h"
+#include "pathtokenizer.h"
+
+namespace veqtor::utils {
+QTransform transformStack::entry::toTransform() const {
+    QTransform t;
+    switch(kind) {
+        case Translate: t.translate(v[0], v[1]); break;
+        case Scale: t.scale(v[0], v[1]); break;
+        case Rotate:
+            t.translate(v[1], v[2]);
+            t.rotate(v[0], axis);
+            t.translate(-v[1], -v[2]);
+            break;
+        case Shear: t.shear(v[0], v[1]); break;
+        case Matrix: t.setMatrix(v[0], v[1], 0, v[2], v[3], 0, v[4], v[5], 1); break;
+    }
+    return t;
+}
+
+transformStack transformStack::parse(QStringView value) {
+    transformStack stack;
+    qsizetype i = 0;
+    const qsizetype size = value.size();
+    const auto isSpace = [](QChar c) { return c.isSpace() || c == QLatin1Char(','); };
+
+    while(i < size) {
+        while(i < size && isSpace(value[i])) ++i;
+        if(i >= size) break;
+
+        const qsizetype nameStart = i;
+        while(i < size && value[i].isLetter()) ++i;
+        const QStringView name = value.mid(nameStart, i - nameStart);
+
+        while(i < size && value[i].isSpace()) ++i;
+        if(i >= size || value[i] != QLatin1Char('(')) break;
+        const qsizetype close = value.indexOf(QLatin1Char(')'), i);
+        if(close < 0) break;
+
+        const std::vector<double> n = pathTokenizer::parseNumbers(value.mid(i + 1, close - i - 1));
+        i = close + 1;
+
+        entry e;
+        if(name == QLatin1String("translate") && (n.size() == 1 || n.size() == 2)) {
+            e.kind = Translate;
+            e.v = {n[0], n.size() > 1 ? n[1] : 0.0};
+        } else if(name == QLatin1String("scale") && (n.size() == 1 || n.size() == 2)) {
+            e.kind = Scale;
+            e.v = {n[0], n.size() > 1 ? n[1] : n[0]};
+        } else if(name == QLatin1String("rotate") && (n.size() == 1 || n.size() == 3)) {
+            e.kind = Rotate;
+            e.v = {n[0], n.size() > 1 ? n[1] : 0.0, n.size() > 1 ? n[2] : 0.0};
+        } else if(name == QLatin1String("skewX") && n.size() == 1) {
+            e.kind = Shear;
+            e.v = {std::tan(qDegreesToRadians(n[0])), 0.0};
+        } else if(name == QLatin1String("skewY") && n.size() == 1) {
+            e.kind = Shear;
+            e.v = {0.0, std::tan(qDegreesToRadians(n[0]))};
+        } else if(name == QLatin1String("matrix") && n.size() == 6) {
+            e.kind = Matrix;
+            std::copy(n.begin(), n.end(), e.v.begin());
+        } else {
+            qWarning("Veqtor: invalid transform at position %lld.", static_cast<long long>(nameStart));
+            break;
+        }
+        stack.append(e);
+    }
+    return stack;
+}
+
+transformStack transformStack::fromVariant(const QList<QVariantMap> &list) {
+    transformStack stack;
+    for(const QVariantMap &t: list) {
+        const QString type = t["t"].toString();
+        entry e;
+        if(type == "rotate") {
+            e.kind = Rotate;
+            e.axis = t["axis"].isNull() ? Qt::ZAxis : Qt::Axis(t["axis"].toInt());
+            e.v = {t["angle"].toDouble(), t["cx"].toDouble(), t["cy"].toDouble()};
+        } else if(type == "scale") {
+            e.kind = Scale;
+            e.v = {t["x"].toDouble(), t["y"].toDouble()};
+        } else if(type == "shear") {
+            e.kind = Shear;
+            e.v = {t["h"].toDouble(), t["v"].toDouble()};
+        } else if(type == "translate") {
+            e.kind = Translate;
+            e.v = {t["x"].toDouble(), t["y"].toDouble()};
+        } else if(type == "matrix") {
+            e.kind = Matrix;
+            e.v = {t["a"].toDouble(), t["b"].toDouble(), t["c"].toDouble(),
+                   t["d"].toDouble(), t["e"].toDouble(), t["f"].toDouble()};
+        } else {
+            continue;
+        }
+        stack.append(e);
+    }
+    return stack;
+}
+
+QList<QVariantMap> transformStack::toVariant() const {
+    QList<QVariantMap> list;
+    for(const entry &e: mEntries) {
+        switch(e.kind) {
+            case Translate: list.append(QVariantMap{{"t", "translate"}, {"x", e.v[0]}, {"y", e.v[1]}}); break;
+            case Scale: list.append(QVariantMap{{"t", "scale"}, {"x", e.v[0]}, {"y", e.v[1]}}); break;
+            case Rotate:
+                list.append(QVariantMap{{"t", "rotate"}, {"angle", e.v[0]}, {"cx", e.v[1]}, {"cy", e.v[2]}, {"axis", int(e.axis)}});
+                break;
+            case Shear: list.append(QVariantMap{{"t", "shear"}, {"h", e.v[0]}, {"v", e.v[1]}}); break;
+            case Matrix:
+                list.append(QVariantMap{{"t", "matrix"}, {"a", e.v[0]}, {"b", e.v[1]}, {"c", e.v[2]},
+                                        {"d", e.v[3]}, {"e", e.v[4]}, {"f", e.v[5]}});
+                break;
+        }
+    }
+    return list;
+}
+
+void transformStack::append(const entry &e) {
+    mEntries.push_back(e);
+}
+
+void transformStack::clear() {
+    mEntries.clear();
+    mProducts.clear();
+    mValid = 0;
+}
+
+bool transformStack::setTranslation(int index, const QPointF &offset) {
+    return set(index, Translate, offset.x(), offset.y());
+}
+
+bool transformStack::setScale(int index, qreal sx, qreal sy) {
+    return set(index, Scale, sx, sy);
+}
+
+bool transformStack::setRotation(int index, qreal angle) {
+    if(index < 0 || index >= size() || mEntries[index].kind != Rotate) return false;
+    if(mEntries[index].v[0] != angle) {
+        mEntries[index].v[0] = angle;
+        invalidateFrom(index);
+    }
+    return true;
+}
+
+bool transformStack::setShear(int index, qreal sh, qreal sv) {
+    return set(index, Shear, sh, sv);
+}
+
+bool transformStack::set(int index, Kind kind, qreal a, qreal b) {
+    if(index < 0 || index >= size() || mEntries[index].kind != kind) return false;
+    entry &e = mEntries[index];
+    if(e.v[0] != a || e.v[1] != b) {
+        e.v[0] = a;
+        e.v[1] = b;
+        invalidateFrom(index);
+    }
+    return true;
+}
+
+QTransform transformStack::matrix(const QPointF &origin) const {
+    mProducts.resize(mEntries.size());
+    mValid = std::min(mValid, size());
+
+    /// An operation is applied before the ones that precede it in the list.
+    for(; mValid < size(); ++mValid) {
+        const QTransform t = mEntries[mValid].toTransform();
+        mProducts[mValid] = mValid ? t * mProducts[mValid - 1] : t;
+    }
+
+    const QTransform product = mEntries.empty() ? QTransform() : mProducts.back();
+    if(origin.isNull()) return product;
+    return QTransform::fromTranslate(-origin.x(), -origin.y()) * product *
+           QTransform::fromTranslate(origin.x(), origin.y());
+}
+} // namespace veqtor::utils
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include <QStringView>
+#include <QTransform>
+#include <QVariantMap>
+#include <QtMath>
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace veqtor::utils {
+/**
+ * @brief The transformStack class
+ * @abstract A typed list of transform operations, e.g. `translate(10 0) rotate(45)`.
+ *  The operations are applied in the SVG order (the last one is applied to the points first).
+ *  The partial products of the list are cached, so changing an operation only recomposes
+ *  the operations after it (e.g. animating the last rotation is O(1)).
+ */
+class transformStack {
+public:
+    enum Kind : std::uint8_t { Translate, Scale, Rotate, Shear, Matrix };
+
+    /**
+     * @brief The entry struct
+     * @list
+     * @li Translate: x, y
+     * @li Scale: x, y
+     * @li Rotate: angle (degrees), center x, center y
+     * @li Shear: horizontal, vertical
+     * @li Matrix: a, b, c, d, e, f
+     * @endlist
+     */
+    struct entry {
+        Kind kind = Translate;
+        Qt::Axis axis = Qt::ZAxis;
+        std::array<qreal, 6> v{};
+
+        QTransform toTransform() const;
+        bool operator == (const entry &other) const {
+            return kind == other.kind && axis == other.axis && v == other.v;
+        }
+        bool operator != (const entry &other) const { return !(*this == other); }
+    };
+
+    transformStack() = default;
+
+    /**
+     * @brief parse
+     * @abstract Parses the SVG `transform` attribute, the list ends at the first malformed operation.
+     * @param value, e.g. "translate(10, 20) rotate(45 5 5) skewX(10)".
+     */
+    static transformStack parse(QStringView value);
+
+    /** @brief fromVariant, Converts the QML list format ({t: "rotate", angle: 45}, ...). */
+    static transformStack fromVariant(const QList<QVariantMap> &list);
+    QList<QVariantMap> toVariant() const;
+
+    /// modifiers
+    void append(const entry &e);
+    void clear();
+    /** @return false if the index is out of range or it's not an operation of the same kind. */
+    bool setTranslation(int index, const QPointF &offset);
+    bool setScale(int index, qreal sx, qreal sy);
+    bool setRotation(int index, qreal angle);
+    bool setShear(int index, qreal sh, qreal sv);
+
+    /// getters
+    int size() const { return static_cast<int>(mEntries.size()); }
+    bool empty() const { return mEntries.empty(); }
+    const entry &at(int index) const { return mEntries[index]; }
+
+    /**
+     * @brief matrix
+     * @return Product of all of the operations, about the given origin.
+     */
+    QTransform matrix(const QPointF &origin = QPointF()) const;
+
+    bool operator == (const transformStack &other) const { return mEntries == other.mEntries; }
+    bool operator != (const transformStack &other) const { return !(*this == other); }
+
+private:
+    bool set(int index, Kind kind, qreal a, qreal b);
+    void invalidateFrom(int index) { mValid = std::min(mValid, index); }
+
+    std::vector<entry> mEntries;
+    /// mProducts[i] is the product of the first i + 1 operations, the first `mValid` products are valid.
+    mutable std::vector<QTransform> mProducts;
+    mutable int mValid = 0;
+};
+} // namespace veqtor::utils
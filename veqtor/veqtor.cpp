@@ -2,6 +2,9 @@
 #include <QPointF>
 #include <QLine>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QQuickWindow>
+#include <QCoreApplication>
 
 #include "veqtor.h"
 #include "nanopainter.h"
@@ -12,19 +15,18 @@
 #include "utils/svgtools.h"
 
 #include "painthelper.h"
+#include "renderer.h"
 
 namespace veqtor::canvas {
 veqtor::veqtor(QQuickItem *parent) : QNanoQuickItem(parent) {
-    /// This line sets timer values.
-    /// The timer is used to limit the update and paint framerate to 60 FPS.
-    mUpdateTimer.setInterval(1000/60 - 1.5);
-    mUpdateTimer.setSingleShot(true);
-    mUpdateTimer.callOnTimeout(this, &QQuickItem::update);
-
     connect(this, &veqtor::widthChanged, this, &veqtor::adjustResponsive);
     connect(this, &veqtor::heightChanged, this, &veqtor::adjustResponsive);
 }
 
+veqtor::~veqtor() {
+    cancelLoading();
+}
+
 QNanoQuickItemPainter *veqtor::createItemPainter() const {
     core::nanoPainter *itemPainter = new core::nanoPainter();
     itemPainter->setCanvas(this);
@@ -34,56 +36,83 @@ QNanoQuickItemPainter *veqtor::createItemPainter() const {
 void veqtor::hoverMoveEvent(QHoverEvent* event) {
     using elements::element;
 
-    if(mRoot) {
+    if(mScene) {
 #if QT_VERSION_MAJOR == 6
         QPointF mousePosition = event->position();
 #else
         QPointF mousePosition = event->posF();
 #endif
-        /// Walk through all of the shape element nodes.
-        /// The `any` function acts as a pre-order traversal, going through all the elements.
-        /// TODO: Change the traversal type to reversed post-order.
-        mRoot->any([&mousePosition, this](const QPointer<element> &el) {
-            bool contains = el->contains(mousePosition);
-            if(contains) emit hovered(el);
-            return contains;
-        });
+        /// The index returns the candidates topmost first, so the first hit is the hovered element.
+        ///  Its element is only created if the signal is connected.
+        const QPointF point = mAdjustment.inverted().map(mousePosition);
+        for(const int id: mSpatialIndex.query(point)) {
+            const int node = mScene->graphics()[id];
+            if(mScene->contains(node, point)) {
+                if(isSignalConnected(QMetaMethod::fromSignal(&veqtor::hovered))) emit hovered(mScene->wrapper(node));
+                break;
+            }
+        }
     }
     QQuickItem::hoverMoveEvent(event);
 }
 
-void veqtor::componentComplete() {
-    /**
-     * @abstract In this section, we connect all QML-side declared properties to the "updateElementAttributes()" slot.
-     *  The signal names are a mix of the signal code,
-     *   the property name and the "Changed()" string. (In example: for `property var pathId`, signal name is `2pathIdChanged()`)
-     */
-    int num = metaObject()->propertyCount();
-    for(int i = metaObject()->propertyOffset() + 1; i < num; ++i) {
-        QMetaProperty mp = metaObject()->property(i);
-        if(mp.isWritable() && !mp.isConstant()) {
-            QByteArray signalName = QT_STRINGIFY(QSIGNAL_CODE) + QByteArray(mp.name()) + "Changed()";
-            connect(this, signalName.constData(), this, SLOT(updateElementAttributes()));
-        }
+QPointer<elements::svg> veqtor::root() const {
+    return mScene ? qobject_cast<elements::svg*>(mScene->wrapper(0).data()) : nullptr;
+}
+
+QVariantMap veqtor::document() const {
+    QVariantMap document;
+    if(!mScene) return document;
+    for(auto i = mScene->ids().cbegin(); i != mScene->ids().cend(); ++i) {
+        document.insert(i.key(), QVariant::fromValue(mScene->wrapper(i.value()).data()));
     }
+    return document;
+}
 
-    setElementsToProperties();
+QVariant veqtor::getElementById(const QString &id) const {
+    const int node = mScene ? mScene->find(id) : -1;
+    return node < 0 ? QVariant() : QVariant::fromValue(mScene->wrapper(node).data());
+}
 
-    QQuickItem::componentComplete();
+QVariantList veqtor::elementsAt(const QPointF &point) const {
+    QVariantList elements;
+    if(!mScene) return elements;
+    /// The shapes are hit-tested in the scene, so elements are only created for the hits.
+    const QPointF p = mAdjustment.inverted().map(point);
+    for(const int id: mSpatialIndex.query(p)) {
+        const int node = mScene->graphics()[id];
+        if(mScene->contains(node, p)) elements.push_back(QVariant::fromValue(mScene->wrapper(node).data()));
+    }
+    return elements;
 }
 
-void veqtor::painter(QNanoPainter *painter) const {
-    using elements::element;
+QVariantList veqtor::elementsIn(const QRectF &rect) const {
+    QVariantList elements;
+    if(!mScene) return elements;
+    for(const int id: mSpatialIndex.query(mAdjustment.inverted().mapRect(rect))) {
+        elements.push_back(QVariant::fromValue(mScene->wrapper(mScene->graphics()[id]).data()));
+    }
+    return elements;
+}
 
-    if(!mRoot) return;
+void veqtor::componentComplete() {
+    bindProperties();
+    resolveBindings();
 
-    /// Walk through all of the shape element nodes.
-    mRoot->walk([&painter, this](const QPointer<element> &el) {
-        if(el->isGraphic()) {
-            auto graphic = dynamic_cast<elements::graphic*>(el.data());
-            paintHelper::drawShape(painter, *graphic, graphic->pen(), mAdjustment);
-        }
-    });
+    QQuickItem::componentComplete();
+}
+
+void veqtor::snapshot(std::vector<displayList::item> &frame) const {
+    /// Cull the shapes that are completely outside of the item.
+    if(mScene) mDisplayList.snapshot(mViewport, frame, mInside);
+    else frame.clear();
+}
+
+void veqtor::painter(QNanoPainter *painter, const std::vector<displayList::item> &frame) const {
+    ++mRenderedFrames;
+    const auto stats = paintHelper::drawList(painter, frame);
+    mDrawCalls = stats.drawCalls;
+    mMergedDrawCalls = stats.merged;
 }
 
 void veqtor::setSrc(const QString &src) {
@@ -91,62 +120,256 @@ void veqtor::setSrc(const QString &src) {
     mSrc = src;
     emit srcChanged();
 
-    QString data = utils::tools::contentResolver(src);
+    /// The result of a load that is still in progress belongs to the old source.
+    cancelLoading();
 
-    /// Delete old tree
-    /// There is a chance that svgParser return nullptr value, and this would cause
-    if(mRoot) mRoot->deleteLater();
-    mRoot = nullptr;
+    if(mAsynchronous && !src.isEmpty()) {
+        loadAsync(src);
+    } else {
+        QString data = utils::tools::contentResolver(src);
+        setScene(utils::svgTools::sceneParser(data));
+    }
+}
+
+void veqtor::setAsynchronous(bool asynchronous) {
+    if(mAsynchronous == asynchronous) return;
+    mAsynchronous = asynchronous;
+    emit asynchronousChanged();
+}
 
-    /// Generate new tree
-    const auto root = utils::svgTools::svgParser(data, this);
+void veqtor::loadAsync(const QString &src) {
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    mLoadCancelled = cancelled;
+
+    setStatus(Loading);
+    setProgress(0.0);
+
+    /// The worker never touches the item itself, results are queued to the application object
+    ///  (which lives in the item's thread), and the item pointer is only checked there.
+    QPointer<veqtor> self(this);
+
+    QThreadPool::globalInstance()->start([self, src, cancelled]() {
+        QObject *app = QCoreApplication::instance();
+        const QString data = utils::tools::contentResolver(src);
+        int percent = 0;
+
+        const auto progress = [&](qreal value) {
+            if(*cancelled) return false;
+            /// Report at most one progress update per percent.
+            if(int(value * 100) > percent) {
+                percent = int(value * 100);
+                QMetaObject::invokeMethod(app, [self, cancelled, value]() {
+                    if(self && !*cancelled) self->setProgress(value);
+                }, Qt::QueuedConnection);
+            }
+            return true;
+        };
 
-    if(root && root->type() == elements::element::SVG) {
-        mRoot = dynamic_cast<elements::svg*>(root.data());
-        mDocument.clear();
-        mRoot->walk([this](const QPointer<elements::element>& el) {
-            connect(el, &elements::element::updated, this, &veqtor::update);
+        const std::shared_ptr<core::scene> scene = utils::svgTools::sceneParser(data, progress);
 
-            if(!el->id().isEmpty()) {
-                mDocument[el->id()] = QVariant::fromValue(el.data());
+        /// A discarded scene has no elements, so it can be released on any thread.
+        QMetaObject::invokeMethod(app, [self, cancelled, scene]() {
+            if(self && !*cancelled) {
+                self->mLoadCancelled.reset();
+                self->setScene(scene);
             }
-        });
+        }, Qt::QueuedConnection);
+    });
+}
 
-        connect(mRoot, &elements::svg::viewBoxChanged, this, &veqtor::adjustSize);
+void veqtor::cancelLoading() {
+    if(mLoadCancelled) {
+        *mLoadCancelled = true;
+        mLoadCancelled.reset();
+    }
+}
+
+void veqtor::setScene(const std::shared_ptr<core::scene> &scene) {
+    /// The elements of the old scene are unbound and deleted later by the scene.
+    if(mScene) mScene->setWrapperHook({});
+    mScene.reset();
+    mDisplayList.clear();
+
+    if(scene && !scene->empty() && (*scene)[0].type == elements::element::SVG) {
+        mScene = scene;
+        mScene->setOwner(this);
+        mScene->setWrapperHook([this](elements::element *el) { connectElement(el); });
 
+        rebuildDisplayList();
         adjustSize();
-        setElementsToProperties();
+        resolveBindings();
 
+        setProgress(1.0);
+        setStatus(Ready);
         emit documentChanged();
         emit rootChanged();
         QTimer::singleShot(0, this, &veqtor::svgLoaded);
+    } else {
+        /// There is a chance that the parser returns nullptr or a non-svg root.
+        mSpatialIndex.clear();
+        /// The old elements are deleted later, so the bindings are dropped now.
+        resolveBindings();
+
+        setProgress(0.0);
+        setStatus(mSrc.isEmpty() ? Null : Error);
+        emit documentChanged();
+        emit rootChanged();
+    }
+
+    update();
+}
+
+void veqtor::connectElement(elements::element *el) {
+    /// Graphics report their damaged area, other elements re-resolve and repaint their subtree.
+    if(auto graphic = qobject_cast<elements::graphic*>(el)) {
+        graphic->updatePaintRect();
+        connect(graphic, &elements::graphic::damaged, this, &veqtor::addDamage);
+        connect(graphic, &elements::graphic::damaged, this, &veqtor::updateGraphic);
+    } else {
+        connect(el, &elements::element::updated, this, &veqtor::updateSubtree);
     }
+    if(auto root = qobject_cast<elements::svg*>(el)) {
+        connect(root, &elements::svg::viewBoxChanged, this, &veqtor::adjustSize);
+    }
+    connect(el, &elements::element::idChanged, this, &veqtor::documentChanged);
+}
 
+void veqtor::rebuildSpatialIndex() {
+    const auto &items = mDisplayList.items();
+    QRectF bounds = mScene ? mScene->viewBox() : QRectF();
+    if(!bounds.isValid()) {
+        for(const auto &item: items) bounds = bounds.united(item.paintRect);
+    }
+
+    mSpatialIndex.reset(bounds, static_cast<int>(items.size()));
+    for(size_t id = 0; id < items.size(); ++id) {
+        mSpatialIndex.insert(static_cast<int>(id), items[id].paintRect);
+    }
+}
+
+void veqtor::rebuildDisplayList() {
+    mDisplayList.setRootTransform(mAdjustment);
+    if(mScene) mDisplayList.build(*mScene);
+    else mDisplayList.clear();
+    rebuildSpatialIndex();
     update();
 }
 
-void veqtor::setElementsToProperties() {
+void veqtor::updateGraphic() {
+    const auto el = qobject_cast<elements::element *>(sender());
+    if(!mScene || !el || el->scene() != mScene.get()) return;
+
+    const int id = (*mScene)[el->node()].graphic;
+    if(id < 0) return;
+    mDisplayList.update(id, *mScene);
+    mSpatialIndex.update(id, mDisplayList.items()[id].paintRect);
+}
+
+void veqtor::updateSubtree() {
+    const auto el = qobject_cast<elements::element *>(sender());
+    if(mScene && el && el->scene() == mScene.get()) {
+        const auto range = mScene->graphicRange(el->node());
+        for(int id = range.first; id < range.second; ++id) {
+            mDisplayList.update(id, *mScene);
+            mSpatialIndex.update(id, mDisplayList.items()[id].paintRect);
+        }
+    }
+    update();
+}
+
+void veqtor::setStatus(Status status) {
+    if(mStatus == status) return;
+    mStatus = status;
+    emit statusChanged();
+}
+
+void veqtor::setProgress(qreal progress) {
+    if(qFuzzyCompare(mProgress, progress)) return;
+    mProgress = progress;
+    emit progressChanged();
+}
+
+void veqtor::bindProperties() {
     /**
-     * @brief Set elements to the names of their associated properties depending on their Ids.
-     *  Put the element pointer into @a evar, and if the element exists,
-     *  assign data from the property with the same name as the element ID to it.
+     * @abstract The QML-side declared properties are bound to the elements with the same ids (In example:
+     *  `property var pathId: ({fill: "red"})` sets the attributes of the element with `id="pathId"`).
+     *  Their notify signals are connected by index and mapped to the bindings here, so a change is dispatched
+     *  without any name lookup. The properties of every QML type between the item and veqtor are bound.
      */
+    const int methodOffset = staticMetaObject.methodCount();
+    const int slot = staticMetaObject.indexOfSlot("propertyChanged()");
+    mBindings.clear();
+    mSignalBindings.assign(metaObject()->methodCount() - methodOffset, -1);
+
+    for(const QMetaObject *meta = metaObject(); meta && meta != &staticMetaObject; meta = meta->superClass()) {
+        for(int i = meta->propertyOffset(); i < meta->propertyCount(); ++i) {
+            const QMetaProperty mp = meta->property(i);
+            if(!mp.isWritable() || mp.isConstant() || !mp.hasNotifySignal()) continue;
+            const int signal = mp.notifySignalIndex() - methodOffset;
+            if(signal < 0 || mSignalBindings[signal] >= 0) continue;
+
+            mSignalBindings[signal] = static_cast<int>(mBindings.size());
+            mBindings.push_back({mp, nullptr, {}});
+            QMetaObject::connect(this, mp.notifySignalIndex(), this, slot);
+        }
+    }
+}
 
-    int num = metaObject()->propertyCount();
-    for(int i = metaObject()->propertyOffset(); i < num; ++i) {
-        QMetaProperty mp = metaObject()->property(i);
-        QVariant evar = mDocument[mp.name()];
-        auto name = mp.name();
+void veqtor::resolveBindings() {
+    for(propertyBinding &binding: mBindings) {
+        const int node = mScene ? mScene->find(QString::fromLatin1(binding.property.name())) : -1;
+        binding.target = node < 0 ? nullptr : mScene->wrapper(node);
+        /// The setters belong to the type of the old target.
+        binding.setters.clear();
+        applyBinding(binding);
+    }
+}
 
-        if(evar.isValid()) {
-            auto eptr = evar.value<elements::element*>();
-            if(eptr) eptr->setAttributes(property(name).toMap());
+void veqtor::applyBinding(propertyBinding &binding) {
+    /// Changes before the document is loaded are applied when the targets are resolved.
+    if(!binding.target) return;
+    const QVariantMap attrs = binding.property.read(this).toMap();
+    if(attrs.isEmpty()) return;
+
+    /// The attributes are written through the typed setters of the target, and it's repainted once for all of them.
+    ///  Removed attributes, values that don't convert (e.g. lengths with units) and the other attributes are
+    ///  parsed by `setAttributes`.
+    elements::element::updateScope scope(binding.target);
+    QVariantMap rest;
+    for(auto i = attrs.cbegin(); i != attrs.cend(); ++i) {
+        const QMetaProperty &property = setterOf(binding, i.key()).property;
+        if(i.value().isNull() || !property.isValid() || !property.write(binding.target, i.value())) {
+            rest.insert(i.key(), i.value());
         }
     }
+    if(!rest.isEmpty()) binding.target->setAttributes(rest);
+}
+
+const veqtor::attributeSetter &veqtor::setterOf(propertyBinding &binding, const QString &key) {
+    for(const attributeSetter &setter: binding.setters) {
+        if(setter.key == key) return setter;
+    }
+
+    QString name;
+    name.reserve(key.size());
+    for(int i = 0; i < key.size(); ++i) {
+        if(key[i] == '-' && i + 1 < key.size()) name += key[++i].toUpper();
+        else name += key[i];
+    }
+    /// Only the properties of the elements are setters, not the ones of QObject (e.g. `objectName`).
+    const QMetaObject *meta = binding.target->metaObject();
+    const int index = meta->indexOfProperty(name.toLatin1().constData());
+    QMetaProperty property;
+    if(index >= elements::element::staticMetaObject.propertyOffset() && meta->property(index).isWritable()) {
+        property = meta->property(index);
+    }
+    binding.setters.push_back({key, property});
+    return binding.setters.back();
 }
 
 void veqtor::adjustSize() {
-    QRectF viewBox = mRoot->viewBox();
+    if(!mScene) return;
+    QRectF viewBox = mScene->viewBox();
 
     /// If the root changes, update the source size, implicit width, and implicit height.
     if(viewBox.isValid()) {
@@ -159,9 +382,9 @@ void veqtor::adjustSize() {
 }
 
 void veqtor::adjustResponsive() {
-    if(!mRoot) return;
+    if(!mScene) return;
 
-    QRectF viewBox  = mRoot->viewBox();
+    QRectF viewBox  = mScene->viewBox();
 
     /// If width or height is not valid, set its value based on the viewbox size.
     if(!widthValid() || !heightValid()) {
@@ -170,44 +393,132 @@ void veqtor::adjustResponsive() {
         if(!heightValid()) setImplicitHeight(width() / _ratio);
     }
 
-    float scale  = std::min({width()/viewBox.width(), height()/viewBox.height()});
-    QPointF offset{width() - scale * viewBox.width(), height() - scale * viewBox.height()};
+    mViewport = QRectF(0, 0, width(), height());
+    /// Center the SVG shape in the item and scale it to fit, the same as the offscreen renderer.
+    mAdjustment = renderer::fit(viewBox, mViewport);
+    mDisplayList.setRootTransform(mAdjustment);
+    update();
+}
+
+void veqtor::addDamage(const QRectF &rect) {
+    if(rect.isNull()) {
+        update();
+        return;
+    }
+
+    /// Changes outside of the item don't need a new frame. Visible damage repaints the whole item, the framebuffer
+    ///  of the item painter doesn't keep the previous frame.
+    if(!mAdjustment.mapRect(rect).intersects(mViewport)) return;
+    requestFrame();
+}
 
-    mAdjustment.reset();
-    /// Move the SVG shape to center of Item.
-    mAdjustment.translate(offset.x()/2, offset.y()/2);
-    /// Scale the SVG shape to fit
-    mAdjustment.scale(scale, scale);
-    mAdjustment.translate(-viewBox.x(), -viewBox.y());
+QSGNode *veqtor::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) {
+    /// The GUI thread is blocked here, so this is the frame boundary for the coalesced requests.
+    mFramePending = false;
+    return QNanoQuickItem::updatePaintNode(oldNode, data);
 }
 
 void veqtor::update() {
-    /**
-     * FIXME: Currently, updates occur with a very small delay to prevent high-frequency updates.
-     *  but they should happen instantly in the case of a single update.
-     * The current solution is to use a counter to limit update calls if there are more than two updates.
-     */
+    requestFrame();
+}
+
+void veqtor::requestFrame() {
+    ++mRequestedFrames;
+    if(mUpdateDepth) {
+        mFrameDeferred = true;
+        return;
+    }
+    scheduleFrame();
+}
+
+void veqtor::scheduleFrame() {
+    /// The scene graph renders the item once on its next vsync, later requests join that frame.
+    if(mFramePending) return;
+    mFramePending = true;
+    ++mScheduledFrames;
     QQuickItem::update();
-    if(!mUpdateTimer.isActive() && isEnabled()) {
-        mUpdateTimer.start();
+}
+
+void veqtor::itemChange(ItemChange change, const ItemChangeData &value) {
+    if(change == ItemSceneChange) {
+        /// A pending frame of the old window is never synchronized, so the next request schedules a new one.
+        mFramePending = false;
+        disconnect(mSyncConnection);
+        /// updatePaintNode isn't called for an item that is not rendered (e.g. hidden or empty), but the window
+        ///  still synchronizes. It's emitted on the render thread while the GUI thread is blocked.
+        if(value.window) {
+            mSyncConnection = connect(value.window, &QQuickWindow::beforeSynchronizing, this, [this]() {
+                mFramePending = false;
+            }, Qt::DirectConnection);
+        }
+    } else if(change == ItemVisibleHasChanged) {
+        /// A hidden item is not synchronized, and a shown item is repainted anyway.
+        mFramePending = false;
+    }
+    QNanoQuickItem::itemChange(change, value);
+}
+
+QVariantMap veqtor::frameCounters() const {
+    return {
+        {"requested", mRequestedFrames.load()},
+        {"scheduled", mScheduledFrames.load()},
+        {"rendered",  mRenderedFrames.load() },
+        {"drawCalls", mDrawCalls.load()      },
+        {"merged",    mMergedDrawCalls.load()},
+    };
+}
+
+void veqtor::resetFrameCounters() {
+    mRequestedFrames = mScheduledFrames = mRenderedFrames = 0;
+    mDrawCalls = mMergedDrawCalls = 0;
+}
+
+void veqtor::beginUpdate() {
+    if(mUpdateDepth++ || !mScene) return;
+    /// Nodes without an element can't change, so only the created elements are batched.
+    for(const auto &el: mScene->wrappers()) {
+        if(!el) continue;
+        el->beginUpdate();
+        mBatched.push_back(el);
     }
 }
 
-void veqtor::updateElementAttributes() {
-    /// FIXME: There is a chance that this slot will be called before mRoot initialization.
+void veqtor::endUpdate() {
+    if(!mUpdateDepth) {
+        qWarning("Veqtor: endUpdate is called without beginUpdate.");
+        return;
+    }
+    if(--mUpdateDepth) return;
+
+    /// The elements report their changes here, and they are painted in a single frame.
+    ++mUpdateDepth;
+    std::vector<QPointer<elements::element>> batched;
+    batched.swap(mBatched);
+    for(const auto &el: batched) {
+        if(el) el->endUpdate();
+    }
+    --mUpdateDepth;
 
-    QMetaMethod metaMethod = sender()->metaObject()->method(senderSignalIndex());
-    QByteArray name = metaMethod.name().chopped(7);
-    QVariant prop = property(name.constData());
+    if(mFrameDeferred) {
+        mFrameDeferred = false;
+        scheduleFrame();
+    }
+}
 
-#if QT_VERSION_MAJOR >= 6
-    bool isUserType = prop.typeId() == QMetaType::User;
-#else
-    bool isUserType = prop.type() == QVariant::UserType;
-#endif
-    if(isUserType && mDocument.contains(name) && !mDocument[name].isNull()) {
-        auto elm = mDocument[name].value<elements::element*>();
-        if(elm) elm->setAttributes(prop.toMap());
+void veqtor::batch(const QJSValue &callback) {
+    if(!callback.isCallable()) {
+        qWarning("Veqtor: batch expects a function.");
+        return;
     }
+    beginUpdate();
+    const QJSValue result = callback.call();
+    endUpdate();
+    if(result.isError()) qWarning() << "Veqtor: batch error:" << result.toString();
+}
+
+void veqtor::propertyChanged() {
+    const int signal = senderSignalIndex() - staticMetaObject.methodCount();
+    if(signal < 0 || size_t(signal) >= mSignalBindings.size() || mSignalBindings[signal] < 0) return;
+    applyBinding(mBindings[mSignalBindings[signal]]);
 }
 } // namespace veqtor::canvas
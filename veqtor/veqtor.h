@@ -6,9 +6,10 @@
 
 #include <qnamespace.h>
 
+#include <QMetaProperty>
 #include <QQmlApplicationEngine>
-#include <QTimer>
 
+#include <atomic>
 #include <array>
 #include <cmath>
 #include <vector>
@@ -17,7 +18,16 @@
 
 #include "shapes/shapes.h"
 #include "elements/svg.h"
+#include "elements/eellipse.h"
+#include "elements/eline.h"
 #include "elements/epath.h"
+#include "elements/epolyline.h"
+#include "elements/erect.h"
+#include "elements/eseries.h"
+#include "elements/group.h"
+#include "utils/spatialindex.h"
+#include "displaylist.h"
+#include "scene.h"
 
 namespace veqtor::canvas {
 class veqtor : public QNanoQuickItem {
@@ -30,9 +40,17 @@ class veqtor : public QNanoQuickItem {
     Q_PROPERTY(QVariantMap document READ document NOTIFY documentChanged)
     Q_PROPERTY(QObject* root READ root NOTIFY rootChanged)
     Q_PROPERTY(QSizeF sourceSize READ sourceSize CONSTANT)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+    Q_PROPERTY(Status status READ status NOTIFY statusChanged)
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
 public:
+    /** @brief The loading status, same as `Image.status`. */
+    enum Status { Null, Ready, Loading, Error };
+    Q_ENUM(Status)
+
     /** @brief The Tools enum */
     veqtor(QQuickItem *parent = nullptr);
+    ~veqtor() override;
 
     /**
      * @brief createItemPainter
@@ -55,63 +73,238 @@ public:
     void componentComplete() override;
 
     /**
-     * @brief paintHelper
-     * @param painter
+     * @brief snapshot
+     * @abstract Copies the visible items of the display list (and shares their geometry) for the next frame.
+     *  The item painter calls it in `synchronize`, while the GUI thread is blocked.
+     * @param frame, receives the items, see `displayList::snapshot`.
+     */
+    void snapshot(std::vector<displayList::item> &frame) const;
+
+    /**
+     * @brief painter
+     * @abstract Paints a snapshot on the render thread, it doesn't read the document.
      */
-    void painter(QNanoPainter *painter) const;
+    void painter(QNanoPainter *painter, const std::vector<displayList::item> &frame) const;
 
-    QPointer<elements::svg> root() { return mRoot; }
+    /**
+     * @brief root, document, getElementById
+     * @abstract The document is kept as a `core::scene`, its elements are only created when they are accessed
+     *  here, by `elementsAt`, `elementsIn` or `hovered`, or through the children of a created element.
+     *  `document` creates the elements of all of the nodes that have an id.
+     */
+    QPointer<elements::svg> root() const;
+    const std::shared_ptr<core::scene> &scene() const { return mScene; }
 
     QString src() const { return mSrc; }
     void setSrc(const QString& src);
 
-    QVariantMap document() const { return mDocument; }
+    QVariantMap document() const;
 
-    Q_INVOKABLE QVariant getElementById(const QString &id) {
-        return mDocument[id];
-    }
+    Q_INVOKABLE QVariant getElementById(const QString &id) const;
+
+    /**
+     * @brief elementsAt
+     * @param point, A point in the item coordinates.
+     * @return The graphic elements that contain the point, topmost first.
+     */
+    Q_INVOKABLE QVariantList elementsAt(const QPointF &point) const;
+
+    /**
+     * @brief elementsIn
+     * @param rect, A rectangle in the item coordinates.
+     * @return The graphic elements whose painted area intersects the rectangle, topmost first.
+     */
+    Q_INVOKABLE QVariantList elementsIn(const QRectF &rect) const;
 
     QSizeF sourceSize() const { return mSourceSize; }
 
+    bool asynchronous() const { return mAsynchronous; }
+    void setAsynchronous(bool asynchronous);
+
+    Status status() const { return mStatus; }
+    qreal progress() const { return mProgress; }
+
+    /**
+     * @brief frameCounters
+     * @abstract Counters of the frame scheduler since the last reset (the draw calls of the last frame are reset
+     *  to 0 too), to check that changes are coalesced:
+     * @list
+     * @li requested: repaint requests, usually an `updated` or `damaged` signal of an element.
+     * @li scheduled: frames requested from the scene graph, at most one per synchronization.
+     * @li rendered: frames painted by the render thread.
+     * @li drawCalls: fills and strokes submitted in the last frame.
+     * @li merged: fills and strokes saved in the last frame, by merging shapes of the same style into one path.
+     * @endlist
+     */
+    Q_INVOKABLE QVariantMap frameCounters() const;
+    Q_INVOKABLE void resetFrameCounters();
+
+    /**
+     * @brief beginUpdate, endUpdate
+     * @abstract Batch the changes of the whole document: each created element records its signals
+     *  (see `element::beginUpdate`), and the frame requests are deferred until the outermost batch ends.
+     *  Elements that are created during the batch are not batched.
+     */
+    Q_INVOKABLE void beginUpdate();
+    Q_INVOKABLE void endUpdate();
+    /** @brief batch, Calls the QML function @a callback inside a batch. */
+    Q_INVOKABLE void batch(const QJSValue &callback);
+
+private:
+    /**
+     * @brief loadAsync
+     * @abstract Reads and parses the source on a QThreadPool worker, and builds the scene there.
+     *  The scene has no QObjects, so it's published by `setScene` without moving anything between threads.
+     * @param src
+     */
+    void loadAsync(const QString &src);
+    /** @brief cancelLoading, Cancels the pending asynchronous load (if any), its result is discarded. */
+    void cancelLoading();
+    /**
+     * @brief setScene
+     * @abstract Releases the old scene (its elements are deleted later) and publishes the new one as the document.
+     * @param scene, The new scene, or nullptr. It's rejected if its root is not an `<svg>` node.
+     */
+    void setScene(const std::shared_ptr<core::scene> &scene);
+    /** @brief connectElement, Connects the change signals of an element that is created by the scene. */
+    void connectElement(elements::element *el);
+    void setStatus(Status status);
+    void setProgress(qreal progress);
+    /** @brief rebuildSpatialIndex, Re-creates the hit-test index from the display list items. */
+    void rebuildSpatialIndex();
+
+    /** @brief The attributeSetter struct, an attribute of a bound value and the property of the target that sets it. */
+    struct attributeSetter {
+        QString key;
+        /// Invalid if the attribute isn't a writable property of the target, it's set by `element::setAttributes`.
+        QMetaProperty property;
+    };
+    /** @brief The propertyBinding struct, a QML-declared property and the element with the same id. */
+    struct propertyBinding {
+        QMetaProperty property;
+        QPointer<elements::element> target;
+        /// The setters of the attributes of the value, resolved for the target.
+        std::vector<attributeSetter> setters;
+    };
+    /** @brief bindProperties, Creates the bindings and connects their notify signals, on component completion. */
+    void bindProperties();
+    /** @brief resolveBindings, Finds the target elements in the document, and applies the current values to them. */
+    void resolveBindings();
+    /** @brief applyBinding, Sets the value of the property (an attributes map) to the target element. */
+    void applyBinding(propertyBinding &binding);
+    /**
+     * @brief setterOf
+     * @abstract Returns the setter of the attribute @a key for the target of the binding. It's resolved on the first
+     *  use of the key (the property name is the camel case of the attribute, e.g. `strokeWidth`), and kept.
+     */
+    static const attributeSetter &setterOf(propertyBinding &binding, const QString &key);
+    /**
+     * @brief requestFrame
+     * @abstract Schedules a repaint of the item. Requests are coalesced until the next scene graph
+     *  synchronization, so any number of changes between two vsyncs renders a single frame.
+     */
+    void requestFrame();
+    /** @brief scheduleFrame, Asks the scene graph for a frame, unless one is pending. */
+    void scheduleFrame();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
 private slots:
-    void setElementsToProperties();
     void adjustSize();
     void adjustResponsive();
-    void updateDocument(const QString &newId, const QString &oldId) {
-        /// This slot modifies the main document in the event that the ID of any element is altered.
-        auto sender = qobject_cast<elements::element *>(QObject::sender());
-
-        mDocument.remove(oldId);
-        mDocument.insert(newId, QVariant::fromValue(sender));
-
-        emit documentChanged();
-    }
-    void updateElementAttributes();
+    /** @brief propertyChanged, Applies the binding of the sender notify signal. */
+    void propertyChanged();
+    /**
+     * @brief addDamage
+     * @abstract Requests a new frame only if the damaged area is visible, changes outside of the item are not painted.
+     *  The damage doesn't clip the frame: qnanopainter clears its framebuffer before each paint, so a frame always
+     *  repaints the whole item (only culled by the viewport, see `snapshot`).
+     * @param rect, Damaged area in the root coordinates. A null rect damages the whole item.
+     */
+    void addDamage(const QRectF &rect);
+    /**
+     * @brief rebuildDisplayList
+     * @abstract Re-creates the display list and the hit-test index from the graphic nodes of the scene.
+     *  It's called when a document is loaded.
+     */
+    void rebuildDisplayList();
+    /** @brief updateGraphic, Re-resolves the sender graphic in the display list and the hit-test index. */
+    void updateGraphic();
+    /**
+     * @brief updateSubtree
+     * @abstract Re-resolves the graphics under the sender element (their world state may have changed, whether
+     *  they have an element or not), and repaints the item.
+     */
+    void updateSubtree();
 
 public slots:
     void update();
 
 signals:
     void srcChanged();
+    void asynchronousChanged();
+    void statusChanged();
+    void progressChanged();
     void rootChanged();
     void documentChanged();
     void svgLoaded();
     void hovered(QPointer<elements::element> target);
 
 private:
-    QPointer<elements::svg> mRoot;
-    QVariantMap mDocument;
+    std::shared_ptr<core::scene> mScene;
     QString mSrc;
     QSizeF mSourceSize;
 
-    QTimer mUpdateTimer;
+    bool mAsynchronous = false;
+    Status mStatus = Null;
+    qreal mProgress = 0.0;
+    /// Cancellation flag of the pending asynchronous load, shared with its worker.
+    std::shared_ptr<std::atomic_bool> mLoadCancelled;
+
+    /// A frame is requested from the scene graph and not synchronized yet.
+    bool mFramePending = false;
+    /// Ends the pending frame on each synchronization of the window, whether the item is painted or not.
+    QMetaObject::Connection mSyncConnection;
+    /// Depth of the open batches, the elements in them, and whether a frame was requested in them.
+    int mUpdateDepth = 0;
+    std::vector<QPointer<elements::element>> mBatched;
+    bool mFrameDeferred = false;
+    std::atomic<quint64> mRequestedFrames{0};
+    std::atomic<quint64> mScheduledFrames{0};
+    /// The frames are painted on the render thread.
+    mutable std::atomic<quint64> mRenderedFrames{0};
+    mutable std::atomic<quint64> mDrawCalls{0};
+    mutable std::atomic<quint64> mMergedDrawCalls{0};
+
     QTransform mAdjustment;
+    /// The item area (in item coordinates).
+    QRectF mViewport;
+
+    /// Display list and hit-test index of the graphics, their ids are the scene graphic ids (the paint order).
+    displayList mDisplayList;
+    /// Culling result of the last snapshot, an entry per display list item.
+    mutable std::vector<std::uint8_t> mInside;
+    utils::spatialIndex mSpatialIndex;
+
+    /// Property bindings, and the binding index of each notify signal (relative to the methods of veqtor, or -1).
+    std::vector<propertyBinding> mBindings;
+    std::vector<int> mSignalBindings;
 };
 
 static void registerVeqtorType() {
     qmlRegisterType<veqtor>("veqtor", 0, 1, "Veqtor");
     qmlRegisterType<elements::svg>("veqtor", 0, 1, "Svg");
     qmlRegisterType<elements::epath>("veqtor", 0, 1, "Path");
+    qmlRegisterType<elements::group>("veqtor", 0, 1, "Group");
+    qmlRegisterType<elements::eseries>("veqtor", 0, 1, "Series");
+    qmlRegisterType<elements::erect>("veqtor", 0, 1, "Rect");
+    qmlRegisterType<elements::eellipse>("veqtor", 0, 1, "Ellipse");
+    qmlRegisterType<elements::ecircle>("veqtor", 0, 1, "Circle");
+    qmlRegisterType<elements::eline>("veqtor", 0, 1, "Line");
+    qmlRegisterType<elements::epolyline>("veqtor", 0, 1, "Polyline");
+    qmlRegisterType<elements::epolygon>("veqtor", 0, 1, "Polygon");
 }
 Q_COREAPP_STARTUP_FUNCTION(registerVeqtorType)
 }
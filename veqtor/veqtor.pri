@@ -11,6 +11,12 @@ QT += xml
 CONFIG -= c++11
 CONFIG += c++17 qmltypes
 
+# Build the geometry kernels (utils/simdtools) with AVX2, e.g. `qmake CONFIG+=veqtor_avx2`.
+veqtor_avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2
+}
+
 QML_IMPORT_NAME = veqtor
 QML_IMPORT_MAJOR_VERSION = 1
 
@@ -23,37 +29,77 @@ HEADERS += \
     $$PWD/elements/link.h \
     $$PWD/elements/svg.h \
     $$PWD/elements/graphic.h \
+    $$PWD/elements/group.h \
+    $$PWD/elements/eellipse.h \
     $$PWD/elements/eline.h \
     $$PWD/elements/epath.h \
+    $$PWD/elements/epolyline.h \
+    $$PWD/elements/erect.h \
+    $$PWD/elements/eseries.h \
     $$PWD/elements/unknown.h \
     $$PWD/shapes/apoint.h \
     $$PWD/shapes/ellipse.h \
+    $$PWD/shapes/geometry.h \
+    $$PWD/shapes/geometrycache.h \
     $$PWD/shapes/line.h \
     $$PWD/shapes/path.h \
+    $$PWD/shapes/pathbuffer.h \
     $$PWD/shapes/rectangle.h \
+    $$PWD/shapes/series.h \
     $$PWD/shapes/shape.h \
     $$PWD/shapes/shapes.h \
+    $$PWD/utils/atomtable.h \
+    $$PWD/utils/attributelist.h \
     $$PWD/utils/csstools.h \
+    $$PWD/utils/decimator.h \
+    $$PWD/utils/pathtokenizer.h \
+    $$PWD/utils/simdtools.h \
+    $$PWD/utils/spatialindex.h \
     $$PWD/utils/svgtools.h \
     $$PWD/utils/tools.h \
+    $$PWD/utils/transformstack.h \
     $$PWD/veqtor.h \
     $$PWD/nanopen.h \
+    $$PWD/scene.h \
     $$PWD/painthelper.h \
+    $$PWD/displaylist.h \
+    $$PWD/rasterpainter.h \
+    $$PWD/renderer.h \
     $$PWD/nanopainter.h
 
 SOURCES += \
     $$PWD/elements/element.cpp \
+    $$PWD/elements/eellipse.cpp \
+    $$PWD/elements/eline.cpp \
     $$PWD/elements/epath.cpp \
+    $$PWD/elements/epolyline.cpp \
+    $$PWD/elements/erect.cpp \
+    $$PWD/elements/eseries.cpp \
     $$PWD/elements/graphic.cpp \
     $$PWD/shapes/apoint.cpp \
     $$PWD/shapes/ellipse.cpp \
+    $$PWD/shapes/geometry.cpp \
+    $$PWD/shapes/geometrycache.cpp \
     $$PWD/shapes/line.cpp \
     $$PWD/shapes/path.cpp \
+    $$PWD/shapes/pathbuffer.cpp \
     $$PWD/shapes/rectangle.cpp \
+    $$PWD/shapes/series.cpp \
     $$PWD/shapes/shape.cpp \
+    $$PWD/utils/attributelist.cpp \
     $$PWD/utils/csstools.cpp \
+    $$PWD/utils/decimator.cpp \
+    $$PWD/utils/pathtokenizer.cpp \
+    $$PWD/utils/simdtools.cpp \
+    $$PWD/utils/spatialindex.cpp \
     $$PWD/utils/svgtools.cpp \
     $$PWD/utils/tools.cpp \
+    $$PWD/utils/transformstack.cpp \
     $$PWD/veqtor.cpp \
+    $$PWD/nanopen.cpp \
+    $$PWD/scene.cpp \
     $$PWD/painthelper.cpp \
+    $$PWD/displaylist.cpp \
+    $$PWD/rasterpainter.cpp \
+    $$PWD/renderer.cpp \
     $$PWD/nanopainter.cpp